@@ -0,0 +1,166 @@
+#include "buffer.hh"
+#include "byte_stream.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace std::chrono;
+
+//! Roughly how many bytes each measurement moves
+constexpr size_t target_bytes = 64 * 1024 * 1024;
+
+constexpr size_t write_sizes[] = {1, 16, 256, 1452, 4096, 65536};
+
+//! Folds results into something observable so the compiler can't drop the work
+static size_t sink = 0;
+
+static size_t ops_for(const size_t size) { return min(max(target_bytes / size, size_t(10000)), size_t(2000000)); }
+
+static const char *storage_name(const ByteStream::Storage storage) {
+    return storage == ByteStream::Storage::Ring ? "ring" : "chunked";
+}
+
+//! Time `ops` calls of `op`, then print one CSV row
+template <typename Op>
+static void measure(const string &name, const string &variant, const size_t size, const size_t ops, Op &&op) {
+    const auto start = steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) {
+        op();
+    }
+    const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    const double ns_per_op = double(elapsed) / double(ops);
+    const double bytes_per_sec = double(size) * double(ops) * 1e9 / double(max(elapsed, decltype(elapsed)(1)));
+    cout << name << "," << variant << "," << size << "," << ops << "," << fixed << setprecision(2) << ns_per_op << ","
+         << setprecision(0) << bytes_per_sec << "\n";
+}
+
+//! Write then pop the same amount, so the stream never fills up
+static void bench_write_pop(const ByteStream::Storage storage) {
+    for (const size_t size : write_sizes) {
+        ByteStream stream{max(size, size_t(64 * 1024)), storage};
+        const string chunk(size, 'x');
+
+        measure("write_pop", storage_name(storage), size, ops_for(size), [&] {
+            sink += stream.write(chunk);
+            stream.pop_output(size);
+        });
+        if (storage == ByteStream::Storage::Chunked) {
+            measure("write_move_pop", storage_name(storage), size, ops_for(size), [&] {
+                sink += stream.write(string(chunk));
+                stream.pop_output(size);
+            });
+        }
+    }
+}
+
+//! Keep the stream full: each step frees half a write's worth and then writes a whole one,
+//! so every write stops at the capacity (truncated, or for 1-byte writes, exactly filling it)
+static void bench_capacity_bound(const ByteStream::Storage storage) {
+    const size_t capacity = 64 * 1024;
+    for (const size_t size : write_sizes) {
+        ByteStream stream{capacity, storage};
+        const string chunk(size, 'x');
+        const size_t drain = max(size / 2, size_t(1));
+        while (stream.remaining_capacity()) {
+            stream.write(chunk);
+        }
+
+        measure("capacity_bound", storage_name(storage), size, ops_for(size), [&] {
+            stream.pop_output(drain);
+            sink += stream.write(chunk);
+        });
+    }
+}
+
+//! Fill the stream with `size`-byte writes, then time one way of draining it in `size`-byte steps
+//! (refills are timed too, but are amortized over a megabyte of drains)
+template <typename Drain>
+static void bench_drain(const string &name, const ByteStream::Storage storage, Drain &&drain) {
+    const size_t capacity = 1024 * 1024;
+    for (const size_t size : write_sizes) {
+        ByteStream stream{capacity, storage};
+        const string chunk(size, 'x');
+        const size_t per_fill = capacity / size;
+
+        measure(name, storage_name(storage), size, ops_for(size), [&] {
+            if (stream.buffer_empty()) {
+                for (size_t i = 0; i < per_fill; ++i) {
+                    stream.write(chunk);
+                }
+            }
+            drain(stream, size);
+        });
+    }
+}
+
+static void bench_drains(const ByteStream::Storage storage) {
+    bench_drain("read", storage, [](ByteStream &stream, const size_t size) { sink += stream.read(size).size(); });
+    bench_drain("peek_pop", storage, [](ByteStream &stream, const size_t size) {
+        sink += stream.peek_output(size).size();
+        stream.pop_output(size);
+    });
+    bench_drain("peek_views_pop", storage, [](ByteStream &stream, const size_t size) {
+        sink += stream.peek_views(size).size();
+        stream.pop_output(size);
+    });
+    bench_drain("read_buffer", storage, [](ByteStream &stream, const size_t size) {
+        sink += stream.read_buffer(size).size();
+    });
+}
+
+static void bench_buffers() {
+    for (const size_t size : write_sizes) {
+        const string data(size, 'x');
+        const Buffer buffer{string(data)};
+
+        measure("buffer_adopt", "buffer", size, ops_for(size), [&] { sink += Buffer{string(data)}.size(); });
+        measure("buffer_copy_from", "buffer", size, ops_for(size), [&] { sink += Buffer::copy_from(data).size(); });
+        measure("buffer_share", "buffer", size, ops_for(size), [&] {
+            Buffer copy = buffer;
+            sink += copy.size();
+        });
+        measure("buffer_substr", "buffer", size, ops_for(size), [&] { sink += buffer.substr(size / 2, size).size(); });
+
+        BufferList list;
+        for (size_t i = 0; i < 4; ++i) {
+            list.append(buffer);
+        }
+        measure("bufferlist_append", "bufferlist", size, ops_for(size), [&] {
+            BufferList headers{string(20, 'h')};
+            headers.append(list);
+            sink += headers.buffers().size();
+        });
+        measure("bufferlist_concatenate", "bufferlist", 4 * size, ops_for(4 * size), [&] {
+            sink += list.concatenate().size();
+        });
+        measure("bufferviewlist_iovecs", "bufferviewlist", 4 * size, ops_for(4 * size), [&] {
+            sink += BufferViewList(list).as_iovecs().size();
+        });
+        measure("buffer_gather", "bufferviewlist", 4 * size, ops_for(4 * size), [&] {
+            sink += Buffer::gather(list).size();
+        });
+    }
+}
+
+int main() {
+    try {
+        cout << "benchmark,variant,size,ops,ns_per_op,bytes_per_sec\n";
+        for (const auto storage : {ByteStream::Storage::Chunked, ByteStream::Storage::Ring}) {
+            bench_write_pop(storage);
+            bench_capacity_bound(storage);
+            bench_drains(storage);
+        }
+        bench_buffers();
+    } catch (const exception &e) {
+        cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    cerr << "(checksum " << sink << ")\n";
+    return EXIT_SUCCESS;
+}
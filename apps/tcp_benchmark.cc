@@ -12,8 +12,9 @@ using namespace std::chrono;
 constexpr size_t len = 100 * 1024 * 1024;
 
 void move_segments(TCPConnection &x, TCPConnection &y, vector<TCPSegment> &segments, const bool reorder) {
+    // split super-segments where an adapter would
     while (not x.segments_out().empty()) {
-        segments.emplace_back(move(x.segments_out().front()));
+        x.segments_out().front().split([&](TCPSegment &piece) { segments.emplace_back(move(piece)); });
         x.segments_out().pop();
     }
     if (reorder) {
@@ -28,8 +29,11 @@ void move_segments(TCPConnection &x, TCPConnection &y, vector<TCPSegment> &segme
     segments.clear();
 }
 
-void main_loop(const bool reorder) {
+//! \returns the throughput in Gbit/s
+double main_loop(const bool reorder, const size_t mss = TCPConfig::MAX_PAYLOAD_SIZE, const size_t gso_segments = 1) {
     TCPConfig config;
+    config.mss = mss;
+    config.gso_segments = gso_segments;
     TCPConnection x{config}, y{config};
 
     string string_to_send(len, 'x');
@@ -94,19 +98,27 @@ void main_loop(const bool reorder) {
 
     const auto gigabits_per_second = len * 8.0 / double(duration);
 
-    cout << fixed << setprecision(2);
-    cout << "CPU-limited throughput" << (reorder ? " with reordering: " : "                : ") << gigabits_per_second
-         << " Gbit/s\n";
-
     while (x.active() or y.active()) {
         loop();
     }
+
+    return gigabits_per_second;
 }
 
 int main() {
     try {
-        main_loop(false);
-        main_loop(true);
+        cout << fixed << setprecision(2);
+        cout << "CPU-limited throughput                : " << main_loop(false) << " Gbit/s\n";
+        cout << "CPU-limited throughput with reordering: " << main_loop(true) << " Gbit/s\n";
+
+        // larger segments mean fewer per-segment costs for the same bytes
+        for (const size_t mss : {536, 1460, 8960, 16384}) {
+            cout << "CPU-limited throughput with MSS " << setw(5) << mss << "  : " << main_loop(false, mss)
+                 << " Gbit/s\n";
+        }
+
+        // the same wire segments, but the sender handles 16 at a time
+        cout << "CPU-limited throughput with GSO x16   : " << main_loop(false, 1460, 16) << " Gbit/s\n";
     } catch (const exception &e) {
         cerr << e.what() << "\n";
         return EXIT_FAILURE;
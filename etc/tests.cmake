@@ -13,6 +13,7 @@ add_test(NAME t_recv_window          COMMAND recv_window)
 add_test(NAME t_recv_reorder         COMMAND recv_reorder)
 add_test(NAME t_recv_close           COMMAND recv_close)
 add_test(NAME t_recv_special         COMMAND recv_special)
+add_test(NAME t_recv_autotune        COMMAND recv_autotune)
 
 add_test(NAME t_send_connect         COMMAND send_connect)
 add_test(NAME t_send_transmit        COMMAND send_transmit)
@@ -21,6 +22,13 @@ add_test(NAME t_send_window          COMMAND send_window)
 add_test(NAME t_send_ack             COMMAND send_ack)
 add_test(NAME t_send_close           COMMAND send_close)
 add_test(NAME t_send_extra           COMMAND send_extra)
+add_test(NAME t_send_congestion      COMMAND send_congestion)
+add_test(NAME t_send_rtt             COMMAND send_rtt)
+add_test(NAME t_send_fast_retx       COMMAND send_fast_retx)
+add_test(NAME t_send_retx_queue      COMMAND send_retx_queue)
+add_test(NAME t_send_gso             COMMAND send_gso)
+add_test(NAME t_send_pacing          COMMAND send_pacing)
+add_test(NAME t_send_rack_tlp        COMMAND send_rack_tlp)
 
 add_test(NAME t_strm_reassem_single      COMMAND fsm_stream_reassembler_single)
 add_test(NAME t_strm_reassem_seq         COMMAND fsm_stream_reassembler_seq)
@@ -30,12 +38,19 @@ add_test(NAME t_strm_reassem_many        COMMAND fsm_stream_reassembler_many)
 add_test(NAME t_strm_reassem_overlapping COMMAND fsm_stream_reassembler_overlapping)
 add_test(NAME t_strm_reassem_win         COMMAND fsm_stream_reassembler_win)
 add_test(NAME t_strm_reassem_cap         COMMAND fsm_stream_reassembler_cap)
+add_test(NAME t_strm_reassem_deep        COMMAND fsm_stream_reassembler_deep)
+add_test(NAME t_strm_reassem_bitmap      COMMAND fsm_stream_reassembler_bitmap)
+add_test(NAME t_strm_reassem_ranges      COMMAND fsm_stream_reassembler_ranges)
 
 add_test(NAME t_byte_stream_construction COMMAND byte_stream_construction)
 add_test(NAME t_byte_stream_one_write    COMMAND byte_stream_one_write)
 add_test(NAME t_byte_stream_two_writes   COMMAND byte_stream_two_writes)
 add_test(NAME t_byte_stream_capacity     COMMAND byte_stream_capacity)
 add_test(NAME t_byte_stream_many_writes  COMMAND byte_stream_many_writes)
+add_test(NAME t_byte_stream_ring         COMMAND byte_stream_ring)
+add_test(NAME t_byte_stream_peek_views   COMMAND byte_stream_peek_views)
+add_test(NAME t_byte_stream_spsc         COMMAND byte_stream_spsc)
+add_test(NAME t_tcp_handoff              COMMAND tcp_handoff)
 
 add_test(NAME t_webget               COMMAND "${PROJECT_SOURCE_DIR}/tests/webget_t.sh")
 
@@ -56,6 +71,11 @@ add_test(NAME t_connect              COMMAND fsm_connect_relaxed)
 add_test(NAME ec_listen              COMMAND fsm_listen)
 add_test(NAME t_listen               COMMAND fsm_listen_relaxed)
 add_test(NAME t_winsize              COMMAND fsm_winsize)
+add_test(NAME t_winscale             COMMAND fsm_winscale)
+add_test(NAME t_mss                  COMMAND fsm_mss)
+add_test(NAME t_nagle                COMMAND fsm_nagle)
+add_test(NAME t_timestamps           COMMAND fsm_timestamps)
+add_test(NAME t_delayed_ack          COMMAND fsm_delayed_ack)
 add_test(NAME ec_retx                COMMAND fsm_retx)
 add_test(NAME t_retx                 COMMAND fsm_retx_relaxed)
 add_test(NAME t_retx_win             COMMAND fsm_retx_win)
@@ -232,6 +252,9 @@ add_custom_target (check_lab5 COMMAND "${PROJECT_SOURCE_DIR}/tap.sh" check 10
 add_custom_target (check_lab6 COMMAND ${CMAKE_CTEST_COMMAND} --output-on-failure --timeout 10 -R '^arp_|^router_'
                               COMMENT "Testing Lab 6...")
 
+add_custom_target (bench_buffers COMMAND buffer_benchmark
+                                 COMMENT "Benchmarking ByteStream and buffers (CSV on stdout)...")
+
 add_custom_target (check COMMAND "${PROJECT_SOURCE_DIR}/tun.sh" check 144 145
                          COMMAND "${PROJECT_SOURCE_DIR}/tap.sh" check 10
                          COMMAND ${CMAKE_CTEST_COMMAND} --output-on-failure --timeout 10 -R '^t_|^arp_|^router_'
@@ -2,7 +2,50 @@
 
 using namespace std;
 
+//! \param[in] capacity the maximum number of bytes the stream buffers at once
+//! \param[in] storage how the buffered bytes are stored; Storage::Ring allocates all `capacity` bytes up front
+ByteStream::ByteStream(const size_t capacity, const Storage storage) : _storage{storage}, _cap{capacity} {
+    if (_storage == Storage::Ring)
+        _ring.resize(_cap);
+}
+
+//! \details With Storage::Ring, the buffered bytes move to the front of a new ring of the new size.
+void ByteStream::grow(const size_t capacity) {
+    if (capacity <= _cap)
+        return;
+
+    if (_storage == Storage::Ring) {
+        string ring(capacity, 0);
+        const auto [first, second] = peek_spans(_size);
+        first.copy(&ring[0], first.size());
+        second.copy(&ring[first.size()], second.size());
+        _ring = move(ring);
+        _head = 0;
+    }
+    _cap = capacity;
+}
+
+//! Copy as much of `data` as fits into the ring, wrapping around its end if needed
+size_t ByteStream::ring_write(const string_view data) {
+    const size_t n = min(data.size(), remaining_capacity());
+
+    if (!n)
+        return 0;
+
+    const size_t tail = (_head + _size) % _cap;
+    const size_t first = min(n, _cap - tail);
+    data.copy(&_ring[tail], first);
+    data.copy(&_ring[0], n - first, first);
+
+    _size += n;
+    _has_write += n;
+    return n;
+}
+
 size_t ByteStream::write(string &&data) {
+    if (_storage == Storage::Ring)
+        return ring_write(data);
+
     size_t data_size = data.size();
 
     if (!data_size)
@@ -14,7 +57,8 @@ size_t ByteStream::write(string &&data) {
         if (!left)
             return 0;
 
-        _data.emplace_back(data.substr(0, left));
+        data.resize(left);
+        _data.emplace_back(move(data));
         _size = _cap;
         _has_write += left;
         return left;
@@ -27,6 +71,9 @@ size_t ByteStream::write(string &&data) {
 }
 
 size_t ByteStream::write(const string &data) {
+    if (_storage == Storage::Ring)
+        return ring_write(data);
+
     size_t data_size = data.size();
 
     if (!data_size)
@@ -38,19 +85,22 @@ size_t ByteStream::write(const string &data) {
         if (!left)
             return 0;
 
-        _data.emplace_back(data.substr(0, left));
+        _data.push_back(Buffer::copy_from(string_view(data).substr(0, left)));
         _size = _cap;
         _has_write += left;
         return left;
     }
 
-    _data.emplace_back(std::string(data));
+    _data.push_back(Buffer::copy_from(data));
     _size += data_size;
     _has_write += data_size;
     return data_size;
 }
 
-size_t ByteStream::write(const StringBuffer &data) {
+size_t ByteStream::write(const Buffer &data) {
+    if (_storage == Storage::Ring)
+        return ring_write(data.str());
+
     size_t data_size = data.size();
 
     if (!data_size)
@@ -76,6 +126,14 @@ size_t ByteStream::write(const StringBuffer &data) {
 
 //! \param[in] len bytes will be copied from the output side of the buffer
 string ByteStream::peek_output(const size_t len) const {
+    if (_storage == Storage::Ring) {
+        const auto [first, second] = peek_spans(len);
+        string res;
+        res.reserve(first.size() + second.size());
+        res.append(first).append(second);
+        return res;
+    }
+
     string res;
     res.reserve(min(len, buffer_size()));
     size_t l = len;
@@ -83,17 +141,65 @@ string ByteStream::peek_output(const size_t len) const {
 
     while (it != _data.end() && l >= it->size()) {
         l -= it->size();
-        res.append((it++)->view());
+        res.append((it++)->str());
     }
 
     if (it != _data.end() && l)
-        res.append(it->view().substr(0, l));
+        res.append(it->str().substr(0, l));
+
+    return res;
+}
+
+//! \param[in] len bytes will be viewed from the output side of the buffer
+pair<string_view, string_view> ByteStream::peek_spans(const size_t len) const {
+    const size_t n = min(len, buffer_size());
+
+    if (_storage == Storage::Ring) {
+        const size_t first = min(n, _cap - _head);
+        return {{&_ring[_head], first}, {_ring.data(), n - first}};
+    }
+
+    if (!n)
+        return {};
+
+    const string_view first = _data[0].str().substr(0, n);
+    if (first.size() == n || _data.size() < 2)
+        return {first, {}};
+    return {first, _data[1].str().substr(0, n - first.size())};
+}
+
+//! \param[in] len bytes will be viewed from the output side of the buffer
+BufferViewList ByteStream::peek_views(const size_t len) const {
+    BufferViewList res;
+
+    if (_storage == Storage::Ring) {
+        const auto [first, second] = peek_spans(len);
+        res.append(first);
+        res.append(second);
+        return res;
+    }
+
+    size_t l = len;
+    for (auto it = _data.begin(); it != _data.end() && l; ++it) {
+        const string_view v = it->str().substr(0, l);
+        res.append(v);
+        l -= v.size();
+    }
 
     return res;
 }
 
 //! \param[in] len bytes will be removed from the output side of the buffer
 void ByteStream::pop_output(const size_t len) {
+    if (_storage == Storage::Ring) {
+        const size_t n = min(len, buffer_size());
+        _size -= n;
+        _has_read += n;
+        // an empty ring restarts at offset 0 so the next peek is more likely to be one span
+        _head = _size ? (_head + n) % _cap : 0;
+        return;
+    }
+
     size_t l = len;
     size_t fs;
 
@@ -115,18 +221,24 @@ void ByteStream::pop_output(const size_t len) {
 //! \param[in] len bytes will be popped and returned
 //! \returns a string
 std::string ByteStream::read(const size_t len) {
+    if (_storage == Storage::Ring) {
+        string res = peek_output(len);
+        pop_output(res.size());
+        return res;
+    }
+
     string res;
     res.reserve(min(len, buffer_size()));
     size_t l = len;
 
     while (_data.size() && l >= _data.front().size()) {
         l -= _data.front().size();
-        res.append(_data.front().view());
+        res.append(_data.front().str());
         _data.pop_front();
     }
 
     if (_data.size() && l) {
-        res.append(_data.front().view().substr(0, l));
+        res.append(_data.front().str().substr(0, l));
         _data.front().remove_prefix(l);
     }
 
@@ -134,3 +246,19 @@ std::string ByteStream::read(const size_t len) {
     _has_read += res.size();
     return res;
 }
+
+//! \param[in] len bytes will be popped and returned
+//! \details A segment payload read this way shares the application's bytes, so
+//! the send path and any retransmissions never copy them. Bytes spanning several
+//! chunks (or the ring) are gathered into one pooled Buffer.
+Buffer ByteStream::read_buffer(const size_t len) {
+    const size_t n = min(len, buffer_size());
+
+    Buffer res;
+    if (_storage == Storage::Chunked && n && _data.front().size() >= n)
+        res = _data.front().substr(0, n);
+    else
+        res = Buffer::gather(peek_views(n));
+    pop_output(n);
+    return res;
+}
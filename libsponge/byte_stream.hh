@@ -1,8 +1,12 @@
 #ifndef SPONGE_LIBSPONGE_BYTE_STREAM_HH
 #define SPONGE_LIBSPONGE_BYTE_STREAM_HH
 
+#include "buffer.hh"
+
 #include <deque>
-#include "string_buffer.hh"
+#include <string>
+#include <string_view>
+#include <utility>
 
 //! \brief An in-order byte stream.
 
@@ -10,6 +14,13 @@
 //! side.  The byte stream is finite: the writer can end the input,
 //! and then no more bytes can be written.
 class ByteStream {
+  public:
+    //! How the stream stores the bytes it is holding
+    enum class Storage {
+        Chunked,  //!< One refcounted chunk per write; moving a large string in doesn't copy it
+        Ring      //!< A fixed-capacity contiguous ring; writes and reads never allocate
+    };
+
   private:
     // Your code here -- add private members as necessary.
 
@@ -19,14 +30,19 @@ class ByteStream {
     // different approaches.
 
     bool _error{};  //!< Flag indicating that the stream suffered an error.
-    std::deque<StringBuffer> _data{};
+    Storage _storage;
+    std::deque<Buffer> _data{};  //!< Buffered chunks (Storage::Chunked)
+    std::string _ring{};         //!< `capacity` bytes of backing storage (Storage::Ring)
+    size_t _head{};              //!< Offset in `_ring` of the first buffered byte
     size_t _size{}, _cap;
     size_t _has_read{}, _has_write{};
     bool _end{};
 
+    size_t ring_write(const std::string_view data);
+
   public:
     //! Construct a stream with room for `capacity` bytes.
-    ByteStream(const size_t capacity) : _cap{capacity} {}
+    ByteStream(const size_t capacity, const Storage storage = Storage::Chunked);
 
     //! \name "Input" interface for the writer
     //!@{
@@ -36,11 +52,14 @@ class ByteStream {
     //! \returns the number of bytes accepted into the stream
     size_t write(const std::string &data);
     size_t write(std::string &&data);
-    size_t write(const StringBuffer &data);
+    size_t write(const Buffer &data);
 
     //! \returns the number of additional bytes that the stream has space for
     size_t remaining_capacity() const noexcept { return _cap - buffer_size(); }
 
+    //! Raise the capacity to `capacity` bytes (a smaller value leaves it as it is)
+    void grow(const size_t capacity);
+
     //! Signal that the byte stream has reached its ending
     void end_input() noexcept { _end = true; }
 
@@ -55,6 +74,17 @@ class ByteStream {
     //! \returns a string
     std::string peek_output(const size_t len) const;
 
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns two views that, concatenated, are the front of the stream
+    //! \note With Storage::Ring the views always cover min(len, buffer_size()) bytes.
+    //! With Storage::Chunked they cover at most the first two chunks, so may be shorter.
+    std::pair<std::string_view, std::string_view> peek_spans(const size_t len) const;
+
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns views of the buffered chunks, suitable for FileDescriptor::write
+    //! \note The views are invalidated by the next pop_output() or read()
+    BufferViewList peek_views(const size_t len) const;
+
     //! Remove bytes from the buffer
     void pop_output(const size_t len);
 
@@ -62,6 +92,11 @@ class ByteStream {
     //! \returns a string
     std::string read(const size_t len);
 
+    //! Read (i.e., share and then pop) the next "len" bytes of the stream
+    //! \returns a Buffer that shares the written bytes when they lie in one chunk,
+    //! and otherwise holds a copy of them
+    Buffer read_buffer(const size_t len);
+
     //! \returns `true` if the stream input has ended
     bool input_ended() const noexcept { return _end; }
 
@@ -76,6 +111,9 @@ class ByteStream {
 
     //! \returns `true` if the output has reached the ending
     bool eof() const noexcept { return input_ended() && buffer_empty(); }
+
+    //! \returns how the stream stores its bytes
+    Storage storage() const noexcept { return _storage; }
     //!@}
 
     //! \name General accounting
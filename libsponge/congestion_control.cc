@@ -0,0 +1,101 @@
+#include "congestion_control.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+//! Initial window of RFC 6928: min(10 * MSS, max(2 * MSS, 14600 bytes)), in segments
+static uint64_t initial_window(const size_t mss) { return min<uint64_t>(10, max<uint64_t>(2, 14600 / mss)); }
+
+unique_ptr<CongestionControl> CongestionControl::make(const Algorithm algorithm, const size_t mss) {
+    switch (algorithm) {
+        case Algorithm::NewReno:
+            return make_unique<NewReno>(mss);
+        case Algorithm::Cubic:
+            return make_unique<Cubic>(mss);
+        default:
+            return nullptr;
+    }
+}
+
+NewReno::NewReno(const size_t mss)
+    : _mss(mss), _cwnd(initial_window(mss) * mss), _ssthresh(numeric_limits<uint64_t>::max()) {}
+
+//! \details In slow start the window grows by the bytes acknowledged, at most two
+//! segments per ACK (RFC 3465). Above `ssthresh` it grows by one segment per window
+//! of acknowledged bytes.
+void NewReno::on_ack(const uint64_t acked, const uint64_t) {
+    if (_cwnd < _ssthresh) {
+        _cwnd += min<uint64_t>(acked, 2 * _mss);
+        return;
+    }
+
+    _acked_in_avoidance += acked;
+    if (_acked_in_avoidance >= _cwnd) {
+        _acked_in_avoidance -= _cwnd;
+        _cwnd += _mss;
+    }
+}
+
+void NewReno::on_loss(const uint64_t in_flight, const uint64_t) {
+    _ssthresh = max<uint64_t>(in_flight / 2, 2 * _mss);
+    _cwnd = _ssthresh;
+    _acked_in_avoidance = 0;
+}
+
+void NewReno::on_timeout(const uint64_t in_flight, const uint64_t) {
+    _ssthresh = max<uint64_t>(in_flight / 2, 2 * _mss);
+    _cwnd = _mss;
+    _acked_in_avoidance = 0;
+}
+
+Cubic::Cubic(const size_t mss)
+    : _mss(mss), _cwnd(initial_window(mss)), _ssthresh(numeric_limits<double>::infinity()) {}
+
+//! \details Outside slow start the window follows W(t) = C (t - K)^3 + W_max, where `t`
+//! is the time since the last reduction, or the Reno-friendly estimate if that is larger.
+void Cubic::on_ack(const uint64_t acked, const uint64_t now) {
+    const double segments = double(acked) / double(_mss);
+
+    if (_cwnd < _ssthresh) {
+        _cwnd += min(segments, 2.0);
+        return;
+    }
+
+    if (not _in_epoch) {
+        _in_epoch = true;
+        _epoch_start = now;
+        _k = _cwnd < _w_max ? cbrt((_w_max - _cwnd) / C) : 0;
+        _w_max = max(_w_max, _cwnd);
+        _w_est = _cwnd;
+    }
+
+    const double t = double(now - _epoch_start) / 1000;
+    const double w_cubic = C * pow(t - _k, 3) + _w_max;
+    _w_est += 3 * (1 - BETA) / (1 + BETA) * segments / _cwnd;
+
+    const double target = max(w_cubic, _w_est);
+    if (target > _cwnd) {
+        _cwnd += min(target - _cwnd, _cwnd / 2) / _cwnd * segments;
+    }
+}
+
+void Cubic::reduce() {
+    // fast convergence: release bandwidth sooner if the window keeps shrinking
+    _w_max = _cwnd < _w_last_max ? _cwnd * (1 + BETA) / 2 : _cwnd;
+    _w_last_max = _cwnd;
+    _ssthresh = max(_cwnd * BETA, 2.0);
+    _in_epoch = false;
+}
+
+void Cubic::on_loss(const uint64_t, const uint64_t) {
+    reduce();
+    _cwnd = _ssthresh;
+}
+
+void Cubic::on_timeout(const uint64_t, const uint64_t) {
+    reduce();
+    _cwnd = 1;
+}
@@ -0,0 +1,93 @@
+#ifndef SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
+#define SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+//! \brief A congestion control algorithm, which limits how much a TCPSender keeps in flight
+//! \details The TCPSender sends no more than min(receiver window, cwnd()) sequence numbers
+//! beyond the last ackno, and reports acknowledgments and losses back. All amounts are in
+//! bytes of sequence space; times are the sender's clock in milliseconds.
+class CongestionControl {
+  public:
+    //! Which algorithm a TCPSender should use
+    enum class Algorithm {
+        None,     //!< No congestion window; only the receiver's window limits the sender
+        NewReno,  //!< Slow start, additive increase and halving on loss (RFC 5681, RFC 6582)
+        Cubic     //!< Window growth as a cubic function of time since the last loss (RFC 8312)
+    };
+
+    //! \brief Create the controller for `algorithm` (nullptr for Algorithm::None)
+    //! \param mss is the sender's maximum segment size, in bytes
+    static std::unique_ptr<CongestionControl> make(const Algorithm algorithm, const size_t mss);
+
+    //! The current congestion window
+    virtual uint64_t cwnd() const = 0;
+
+    //! The current slow start threshold
+    virtual uint64_t ssthresh() const = 0;
+
+    //! `acked` sequence numbers were newly acknowledged at time `now`
+    virtual void on_ack(const uint64_t acked, const uint64_t now) = 0;
+
+    //! A segment was found lost without a timeout (e.g. by duplicate acknowledgments),
+    //! with `in_flight` sequence numbers outstanding
+    virtual void on_loss(const uint64_t in_flight, const uint64_t now) = 0;
+
+    //! The retransmission timer expired with `in_flight` sequence numbers outstanding
+    virtual void on_timeout(const uint64_t in_flight, const uint64_t now) = 0;
+
+    virtual ~CongestionControl() = default;
+};
+
+//! \brief NewReno congestion control (RFC 5681, RFC 6582)
+class NewReno : public CongestionControl {
+  private:
+    size_t _mss;
+    uint64_t _cwnd;
+    uint64_t _ssthresh;
+    uint64_t _acked_in_avoidance{};  //!< Bytes acknowledged since cwnd last grew in congestion avoidance
+
+  public:
+    //! \param mss is the sender's maximum segment size, in bytes
+    explicit NewReno(const size_t mss);
+
+    uint64_t cwnd() const override { return _cwnd; }
+    uint64_t ssthresh() const override { return _ssthresh; }
+    void on_ack(const uint64_t acked, const uint64_t now) override;
+    void on_loss(const uint64_t in_flight, const uint64_t now) override;
+    void on_timeout(const uint64_t in_flight, const uint64_t now) override;
+};
+
+//! \brief CUBIC congestion control (RFC 8312)
+class Cubic : public CongestionControl {
+  private:
+    static constexpr double C = 0.4;     //!< Scaling constant of the cubic function
+    static constexpr double BETA = 0.7;  //!< Multiplicative decrease factor
+
+    size_t _mss;
+    double _cwnd;             //!< In segments
+    double _ssthresh;         //!< In segments
+    double _w_max{};          //!< Window (in segments) just before the last reduction
+    double _w_last_max{};     //!< `_w_max` before that, for fast convergence
+    double _w_est{};          //!< Window a Reno flow would have reached since the last reduction
+    double _k{};              //!< Seconds the cubic function takes to get back to `_w_max`
+    bool _in_epoch{};         //!< Whether `_epoch_start` is set
+    uint64_t _epoch_start{};  //!< When window growth resumed after the last reduction
+
+    //! Record a loss: remember the window and lower `_ssthresh` (the caller sets the new window)
+    void reduce();
+
+  public:
+    //! \param mss is the sender's maximum segment size, in bytes
+    explicit Cubic(const size_t mss);
+
+    uint64_t cwnd() const override { return static_cast<uint64_t>(_cwnd * _mss); }
+    uint64_t ssthresh() const override { return static_cast<uint64_t>(_ssthresh * _mss); }
+    void on_ack(const uint64_t acked, const uint64_t now) override;
+    void on_loss(const uint64_t in_flight, const uint64_t now) override;
+    void on_timeout(const uint64_t in_flight, const uint64_t now) override;
+};
+
+#endif  // SPONGE_LIBSPONGE_CONGESTION_CONTROL_HH
@@ -0,0 +1,39 @@
+#include "retransmission_queue.hh"
+
+#include <utility>
+
+using namespace std;
+
+//! \details The ring's size is always a power of two, so indices wrap with a mask.
+void RetransmissionQueue::grow() {
+    vector<Entry> bigger(_ring.empty() ? 16 : 2 * _ring.size());
+    for (size_t i = 0; i < _size; ++i)
+        bigger[i] = move(_ring[(_head + i) & (_ring.size() - 1)]);
+    _ring = move(bigger);
+    _head = 0;
+}
+
+void RetransmissionQueue::push(const uint64_t seqno, const TCPSegment &segment, const uint64_t sent_at) {
+    if (_size == _ring.size())
+        grow();
+    Entry &entry = _ring[(_head + _size) & (_ring.size() - 1)];
+    entry.seqno = seqno;
+    entry.end = seqno + segment.length_in_sequence_space();
+    entry.segment = segment;
+    entry.sent_at = sent_at;
+    entry.retransmitted = false;
+    ++_size;
+}
+
+//! \details Freed slots drop their segment right away, so acknowledged payloads are released
+//! without waiting for the slot to be reused.
+size_t RetransmissionQueue::acknowledge(const uint64_t ackno) {
+    size_t freed = 0;
+    while (_size && _ring[_head].end <= ackno) {
+        _ring[_head].segment = TCPSegment{};
+        _head = (_head + 1) & (_ring.size() - 1);
+        --_size;
+        ++freed;
+    }
+    return freed;
+}
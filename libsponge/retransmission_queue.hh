@@ -0,0 +1,55 @@
+#ifndef SPONGE_LIBSPONGE_RETRANSMISSION_QUEUE_HH
+#define SPONGE_LIBSPONGE_RETRANSMISSION_QUEUE_HH
+
+#include "tcp_segment.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! \brief The segments a TCPSender has sent but not had acknowledged, in sequence order
+//! \details Each segment is stored once, in a ring that doubles when full, together with its
+//! absolute sequence numbers. A cumulative ACK only touches the segments it frees, and a
+//! segment handed out for (re)transmission shares its payload with the stored copy.
+class RetransmissionQueue {
+  public:
+    //! \brief A segment and the absolute sequence numbers [seqno, end) it occupies
+    struct Entry {
+        uint64_t seqno{};
+        uint64_t end{};
+        TCPSegment segment{};
+        uint64_t sent_at{};         //!< When the segment was last (re)transmitted, by the sender's clock
+        bool retransmitted{false};  //!< Whether the segment has been sent more than once
+    };
+
+  private:
+    std::vector<Entry> _ring{};
+    size_t _head{0};  //!< Index of the oldest entry
+    size_t _size{0};  //!< Number of entries held
+
+    //! Move the entries into a ring twice as large, oldest first
+    void grow();
+
+  public:
+    //! \brief Add a segment sent at absolute sequence number `seqno` (after all others held)
+    //! at time `sent_at`
+    void push(const uint64_t seqno, const TCPSegment &segment, const uint64_t sent_at = 0);
+
+    //! \brief Drop the segments wholly below absolute ackno `ackno`
+    //! \returns how many were dropped
+    size_t acknowledge(const uint64_t ackno);
+
+    //! \name Access to the entries, oldest first
+    //!@{
+    bool empty() const noexcept { return _size == 0; }
+    size_t size() const noexcept { return _size; }
+    const Entry &front() const { return _ring[_head]; }
+    const Entry &back() const { return (*this)[_size - 1]; }
+    const Entry &operator[](const size_t i) const { return _ring[(_head + i) & (_ring.size() - 1)]; }
+    Entry &front() { return _ring[_head]; }
+    Entry &back() { return (*this)[_size - 1]; }
+    Entry &operator[](const size_t i) { return _ring[(_head + i) & (_ring.size() - 1)]; }
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_RETRANSMISSION_QUEUE_HH
@@ -0,0 +1,28 @@
+#include "rtt_estimator.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+RTTEstimator::RTTEstimator(const uint64_t initial_rto, const uint64_t rto_min, const uint64_t rto_max)
+    : _rto(initial_rto), _rto_min(rto_min), _rto_max(max(rto_min, rto_max)) {}
+
+//! \details The first sample sets SRTT = R and RTTVAR = R/2; later ones update
+//! RTTVAR before SRTT. Then RTO = SRTT + max(G, 4 * RTTVAR), clamped to [rto_min, rto_max].
+void RTTEstimator::sample(const uint64_t rtt) {
+    const double r = double(rtt);
+    if (not _has_sample) {
+        _srtt = r;
+        _rttvar = r / 2;
+        _has_sample = true;
+    } else {
+        _rttvar = (1 - BETA) * _rttvar + BETA * fabs(_srtt - r);
+        _srtt = (1 - ALPHA) * _srtt + ALPHA * r;
+    }
+    _latest = rtt;
+    _min_rtt = min(_min_rtt, rtt);
+
+    const auto rto = static_cast<uint64_t>(ceil(_srtt + max(GRANULARITY, 4 * _rttvar)));
+    _rto = clamp(rto, _rto_min, _rto_max);
+}
@@ -0,0 +1,44 @@
+#ifndef SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
+#define SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
+
+#include <cstdint>
+
+//! \brief Smoothed round-trip time and retransmission timeout, as in RFC 6298
+//! \details All times are in milliseconds. Until the first sample arrives the RTO
+//! is the initial value it was constructed with.
+class RTTEstimator {
+  private:
+    static constexpr double ALPHA = 1.0 / 8;  //!< Gain of the smoothed RTT
+    static constexpr double BETA = 1.0 / 4;   //!< Gain of the RTT variation
+    static constexpr double GRANULARITY = 1;  //!< Clock granularity (G in RFC 6298)
+
+    double _srtt{};
+    double _rttvar{};
+    uint64_t _latest{};             //!< Most recent sample
+    uint64_t _min_rtt{UINT64_MAX};  //!< Smallest sample seen
+    bool _has_sample{};
+    uint64_t _rto;
+    uint64_t _rto_min;
+    uint64_t _rto_max;
+
+  public:
+    //! \param initial_rto is the RTO to use before any RTT is measured
+    //! \param rto_min and `rto_max` bound the computed RTO
+    RTTEstimator(const uint64_t initial_rto, const uint64_t rto_min, const uint64_t rto_max);
+
+    //! Fold in an RTT measured from an unambiguous acknowledgment (never a retransmitted segment's)
+    void sample(const uint64_t rtt);
+
+    //! \name Current estimates
+    //!@{
+    bool has_sample() const noexcept { return _has_sample; }
+    double srtt() const noexcept { return _srtt; }
+    double rttvar() const noexcept { return _rttvar; }
+    uint64_t latest_rtt() const noexcept { return _latest; }
+    uint64_t min_rtt() const noexcept { return _min_rtt; }
+    uint64_t rto() const noexcept { return _rto; }
+    uint64_t rto_max() const noexcept { return _rto_max; }
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_RTT_ESTIMATOR_HH
@@ -0,0 +1,89 @@
+#include "spsc_byte_stream.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+SPSCByteStream::SPSCByteStream(const size_t capacity) : _ring(capacity, '\0'), _cap{capacity} {}
+
+//! \details Copies the bytes into the ring before publishing the new write count,
+//! so the reader never observes bytes that have not been copied yet.
+size_t SPSCByteStream::write(const string_view data) {
+    const uint64_t written = _written.load(memory_order_relaxed);
+    const uint64_t read = _read.load(memory_order_acquire);
+    const size_t n = min(data.size(), _cap - size_t(written - read));
+
+    if (!n)
+        return 0;
+
+    const size_t tail = written % _cap;
+    const size_t first = min(n, _cap - tail);
+    data.copy(&_ring[tail], first);
+    data.copy(&_ring[0], n - first, first);
+
+    _written.store(written + n, memory_order_release);
+    _data_event.notify();
+    return n;
+}
+
+void SPSCByteStream::end_input() {
+    _end.store(true, memory_order_release);
+    _data_event.notify();
+}
+
+void SPSCByteStream::set_error() {
+    _error.store(true, memory_order_release);
+    _data_event.notify();
+    _space_event.notify();
+}
+
+//! \param[in] len bytes will be viewed from the output side of the buffer
+pair<string_view, string_view> SPSCByteStream::peek_spans(const size_t len) const {
+    const uint64_t read = _read.load(memory_order_relaxed);
+    const size_t n = min(len, size_t(_written.load(memory_order_acquire) - read));
+
+    if (!n)
+        return {};
+
+    const size_t head = read % _cap;
+    const size_t first = min(n, _cap - head);
+    return {{&_ring[head], first}, {_ring.data(), n - first}};
+}
+
+//! \param[in] len bytes will be viewed from the output side of the buffer
+BufferViewList SPSCByteStream::peek_views(const size_t len) const {
+    const auto [first, second] = peek_spans(len);
+    BufferViewList res;
+    res.append(first);
+    res.append(second);
+    return res;
+}
+
+//! \param[in] len bytes will be copied from the output side of the buffer
+string SPSCByteStream::peek_output(const size_t len) const {
+    const auto [first, second] = peek_spans(len);
+    string res;
+    res.reserve(first.size() + second.size());
+    res.append(first).append(second);
+    return res;
+}
+
+//! \details Publishes the new read count before waking the writer, so the
+//! writer sees the freed space as soon as it wakes up.
+void SPSCByteStream::pop_output(const size_t len) {
+    const uint64_t read = _read.load(memory_order_relaxed);
+    const size_t n = min(len, size_t(_written.load(memory_order_acquire) - read));
+
+    if (!n)
+        return;
+
+    _read.store(read + n, memory_order_release);
+    _space_event.notify();
+}
+
+//! \param[in] len bytes will be popped and returned
+string SPSCByteStream::read(const size_t len) {
+    string res = peek_output(len);
+    pop_output(res.size());
+    return res;
+}
@@ -0,0 +1,104 @@
+#ifndef SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
+#define SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
+
+#include "buffer.hh"
+#include "eventfd.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+//! \brief An in-order byte stream shared by one writer thread and one reader thread.
+
+//! Bytes live in a fixed-capacity ring. The writer only ever advances the
+//! count of bytes written and the reader only ever advances the count of
+//! bytes read, so neither side takes a lock. Each side can poll an EventFD
+//! to learn that the other side made progress.
+class SPSCByteStream {
+  private:
+    std::string _ring;  //!< `capacity` bytes of backing storage
+    size_t _cap;
+
+    alignas(64) std::atomic<uint64_t> _written{0};  //!< Total bytes written (stored only by the writer)
+    alignas(64) std::atomic<uint64_t> _read{0};     //!< Total bytes popped (stored only by the reader)
+
+    std::atomic<bool> _end{false};    //!< Flag indicating that the writer ended the input.
+    std::atomic<bool> _error{false};  //!< Flag indicating that the stream suffered an error.
+
+    EventFD _data_event{};   //!< Readable after bytes are written, the input ends, or an error occurs
+    EventFD _space_event{};  //!< Readable after bytes are popped or an error occurs
+
+  public:
+    //! Construct a stream with room for `capacity` bytes.
+    explicit SPSCByteStream(const size_t capacity);
+
+    //! \name "Input" interface for the writer thread
+    //!@{
+
+    //! Write as many bytes of `data` as will fit, and return how many were written.
+    size_t write(const std::string_view data);
+
+    //! \returns the number of additional bytes that the stream has space for
+    size_t remaining_capacity() const noexcept { return _cap - buffer_size(); }
+
+    //! Signal that the byte stream has reached its ending
+    void end_input();
+
+    //! Indicate that the stream suffered an error (may be called by either thread).
+    void set_error();
+
+    //! Becomes readable when the reader pops bytes; the writer polls it while the stream is full
+    EventFD &space_event() noexcept { return _space_event; }
+    //!@}
+
+    //! \name "Output" interface for the reader thread
+    //!@{
+
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns two views that, concatenated, are the front of the stream
+    std::pair<std::string_view, std::string_view> peek_spans(const size_t len) const;
+
+    //! Peek at next "len" bytes of the stream without copying them
+    BufferViewList peek_views(const size_t len) const;
+
+    //! Peek at next "len" bytes of the stream
+    std::string peek_output(const size_t len) const;
+
+    //! Remove bytes from the buffer
+    void pop_output(const size_t len);
+
+    //! Read (i.e., copy and then pop) the next "len" bytes of the stream
+    std::string read(const size_t len);
+
+    //! Becomes readable when the writer writes, ends the input, or sets an error
+    EventFD &data_event() noexcept { return _data_event; }
+
+    //! \returns `true` if the output has reached the ending
+    //! \note Checks the ending first, so a `true` result means every byte has been read.
+    bool eof() const noexcept { return input_ended() && buffer_empty(); }
+    //!@}
+
+    //! \name Accessors safe to call from either thread
+    //!@{
+    bool input_ended() const noexcept { return _end.load(std::memory_order_acquire); }
+    bool error() const noexcept { return _error.load(std::memory_order_acquire); }
+    size_t buffer_size() const noexcept { return bytes_written() - bytes_read(); }
+    bool buffer_empty() const noexcept { return !buffer_size(); }
+    size_t bytes_written() const noexcept { return _written.load(std::memory_order_acquire); }
+    size_t bytes_read() const noexcept { return _read.load(std::memory_order_acquire); }
+    //!@}
+
+    //! \name
+    //! The stream is shared by two threads in place, so it cannot be moved or copied
+
+    //!@{
+    SPSCByteStream(const SPSCByteStream &) = delete;
+    SPSCByteStream(SPSCByteStream &&) = delete;
+    SPSCByteStream &operator=(const SPSCByteStream &) = delete;
+    SPSCByteStream &operator=(SPSCByteStream &&) = delete;
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_SPSC_BYTE_STREAM_HH
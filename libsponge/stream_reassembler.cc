@@ -1,13 +1,26 @@
 #include "stream_reassembler.hh"
 
+#include <algorithm>
 #include <limits>
 
 using namespace std;
 
-StreamReassembler::StreamReassembler(const size_t capacity)
-    : _output(capacity), _capacity(capacity), _eof{numeric_limits<size_t>::max()} {}
+//! \details In Storage::Bitmap mode the ring and bitmap are allocated up front, so
+//! memory use stays fixed however the segments are reordered (until grow() is called).
+StreamReassembler::StreamReassembler(const size_t capacity, const Storage storage, const size_t max_fragments)
+    : _output(capacity)
+    , _capacity(capacity)
+    , _eof{numeric_limits<size_t>::max()}
+    , _max_fragments(max_fragments)
+    , _storage(storage)
+    , _ring(storage == Storage::Bitmap ? capacity : 0, 0)
+    , _bitmap(storage == Storage::Bitmap ? (capacity + 63) / 64 : 0) {}
 
-bool StreamReassembler::cache_push(const uint64_t index, const std::string &data) {
+//! \details Stores the part of `data` that falls inside the window and isn't already
+//! held, leaving any stored fragments untouched. Overlaps are found with a binary
+//! search, so the cost grows with the number of fragments `data` touches rather
+//! than with the number of holes.
+bool StreamReassembler::cache_push(const uint64_t index, const Buffer &data) {
     uint64_t wstart = unassembled(), wend = win_end();
     size_t begin = 0;
     if (wstart > index) {
@@ -21,64 +34,215 @@ bool StreamReassembler::cache_push(const uint64_t index, const std::string &data
         return false;
 
     uint64_t i = begin + index;
-    std::string_view d = std::string_view{data.c_str(), data.size()}.substr(begin, end - begin);
-
-    size_t ie = i + d.size();
-    for (auto it = _cache.begin(); it != _cache.end(); ++it) {
-        auto k = it->first;
-        auto v = it->second;
-        size_t ke = k + v.size();
-        if (k < ie && i < ke) {
-            if (i < k)
-                __cache_add(it, i, string(d.substr(0, k - i)));
-            if (ie <= ke)
-                return true;
-            d.remove_prefix(ke - i);
-            i = ke;
-        }
+    Buffer d = data.substr(begin, end - begin);
+
+    const uint64_t ie = i + d.size();
+
+    // Only the stored fragment starting before `i` and those starting inside [i, ie)
+    // can overlap the new bytes, so skip straight to them.
+    auto it = _cache.upper_bound(i);
+    if (it != _cache.begin() && prev(it)->first + prev(it)->second.size() > i)
+        --it;
+
+    for (; it != _cache.end() && it->first < ie; ++it) {
+        const uint64_t k = it->first;
+        const uint64_t ke = k + it->second.size();
+        if (i < k)
+            __cache_add(it, i, d.substr(0, k - i));
+        if (ie <= ke)
+            return true;
+        d.remove_prefix(ke - i);
+        i = ke;
     }
 
-    __cache_add(_cache.end(), i, string(d));
+    __cache_add(it, i, d);
     return true;
 }
 
-bool StreamReassembler::cache_push(const uint64_t index, std::string &&data) {
-    uint64_t wstart = unassembled(), wend = win_end();
-    size_t begin = 0;
-    if (wstart > index) {
-        begin = wstart - index;
-        if (begin >= data.size())
-            return false;
+//! \details Runs only when the cache holds more than `_max_fragments` entries. The fragments
+//! touching the bytes just pushed, [first, last), are gathered into a single Buffer; if the
+//! cache is still too big, the highest-index fragments are dropped. Only the neighbourhood of
+//! the new bytes is visited, so a push costs a lookup plus the bytes gathered, however many
+//! fragments are held.
+//!
+//! Dropped bytes were never acknowledged (acks are cumulative, and no SACK blocks are sent), so
+//! the peer still holds them and will resend them. A receiver that reported them in SACK blocks
+//! would be reneging (RFC 2018 section 8), and the peer would have to wait for its RTO.
+void StreamReassembler::cache_limit(const uint64_t first, const uint64_t last) {
+    if (!_max_fragments || _cache.size() <= _max_fragments)
+        return;
+
+    auto it = _cache.lower_bound(first);
+    if (it != _cache.begin() && prev(it)->first + prev(it)->second.size() >= first)
+        --it;
+    while (it != _cache.end() && it->first <= last) {
+        auto run_end = next(it);
+        uint64_t end = it->first + it->second.size();
+        BufferViewList run{it->second.str()};
+        for (; run_end != _cache.end() && run_end->first == end && end <= last; ++run_end) {
+            run.append(run_end->second);
+            end += run_end->second.size();
+        }
+        if (run_end != next(it)) {
+            it->second = Buffer::gather(run);
+            _cache.erase(next(it), run_end);
+        }
+        it = run_end;
     }
 
-    size_t end = (wend > index ? wend - index : 0);
-    if (end <= begin)
-        return false;
+    while (_cache.size() > _max_fragments)
+        __cache_del(prev(_cache.end()));
+}
 
-    uint64_t i = begin + index;
-    StringBuffer d = StringBuffer{move(data)}.substr(begin, end - begin);
-
-    size_t ie = i + d.size();
-    for (auto it = _cache.begin(); it != _cache.end(); ++it) {
-        auto k = it->first;
-        auto v = it->second;
-        size_t ke = k + v.size();
-        if (k < ie && i < ke) {
-            if (i < k)
-                __cache_add(it, i, d.substr(0, k - i));
-            if (ie <= ke)
-                return true;
-            d.remove_prefix(ke - i);
-            i = ke;
+//! \brief Set or clear `len` bits of the bitmap starting at bit `pos` (must not wrap)
+//! \returns how many bits changed
+size_t StreamReassembler::bitmap_mark(size_t pos, size_t len, const bool present) {
+    size_t changed = 0;
+    while (len) {
+        const size_t bit = pos % 64;
+        const size_t n = min(len, 64 - bit);
+        const uint64_t mask = (n == 64 ? ~uint64_t{0} : (uint64_t{1} << n) - 1) << bit;
+        uint64_t &word = _bitmap[pos / 64];
+        changed += __builtin_popcountll(mask & (present ? ~word : word));
+        word = present ? word | mask : word & ~mask;
+        pos += n;
+        len -= n;
+    }
+    return changed;
+}
+
+//! \returns how many consecutive bits starting at `pos` are set (or clear, if `present` is false),
+//! up to `max_len`
+//! \details Scans a 64-bit word at a time.
+size_t StreamReassembler::bitmap_run(const size_t pos, const size_t max_len, const bool present) const {
+    size_t run = 0;
+    while (run < max_len) {
+        const size_t bit = (pos + run) % 64;
+        const uint64_t word = _bitmap[(pos + run) / 64];
+        const uint64_t other = (present ? ~word : word) >> bit;
+        const size_t same = min(other ? size_t(__builtin_ctzll(other)) : 64, 64 - bit);
+        run += same;
+        if (same < 64 - bit)
+            break;
+    }
+    return min(run, max_len);
+}
+
+//! \details Copies the part of `data` inside the window into the ring and marks it present.
+void StreamReassembler::bitmap_push(const uint64_t index, const Buffer &data) {
+    const uint64_t first = max(index, unassembled());
+    const uint64_t last = min(index + data.size(), win_end());
+    if (first >= last)
+        return;
+
+    const string_view bytes = data.str().substr(first - index, last - first);
+    const size_t pos = first % _capacity;
+    const size_t head = min(bytes.size(), _capacity - pos);
+    bytes.copy(&_ring[pos], head);
+    bytes.copy(&_ring[0], bytes.size() - head, head);
+    _unass_bytes += bitmap_mark(pos, head, true) + bitmap_mark(0, bytes.size() - head, true);
+}
+
+//! \details Writes out the run of present bytes at the front of the window, in at most two
+//! pieces when it wraps around the end of the ring.
+void StreamReassembler::bitmap_assemble() {
+    while (_unass_bytes) {
+        const size_t pos = unassembled() % _capacity;
+        const size_t run = bitmap_run(pos, _capacity - pos);
+        if (!run)
+            break;
+        assemble(Buffer::copy_from(string_view(_ring).substr(pos, run)));
+        _unass_bytes -= bitmap_mark(pos, run, false);
+    }
+}
+
+//! \details A held byte with stream index `i` moves from `i % old capacity` to `i % capacity`,
+//! a range at a time, split wherever either ring wraps.
+void StreamReassembler::grow(const size_t capacity) {
+    if (capacity <= _capacity)
+        return;
+
+    _output.grow(capacity);
+    if (_storage == Storage::Bitmap) {
+        const auto ranges = held_ranges();
+        const string old_ring = exchange(_ring, string(capacity, 0));
+        const size_t old_capacity = _capacity;
+        _bitmap.assign((capacity + 63) / 64, 0);
+        for (auto [i, last] : ranges) {
+            while (i < last) {
+                const size_t from = i % old_capacity, to = i % capacity;
+                const size_t n = min({last - i, uint64_t{old_capacity - from}, uint64_t{capacity - to}});
+                old_ring.copy(&_ring[to], n, from);
+                bitmap_mark(to, n, true);
+                i += n;
+            }
         }
     }
+    _capacity = capacity;
+}
 
-    __cache_add(_cache.end(), i, d);
-    return true;
+vector<pair<uint64_t, uint64_t>> StreamReassembler::held_ranges() const {
+    vector<pair<uint64_t, uint64_t>> ranges;
+    const auto add = [&](const uint64_t first, const uint64_t last) {
+        if (!ranges.empty() && ranges.back().second == first)
+            ranges.back().second = last;
+        else
+            ranges.emplace_back(first, last);
+    };
+
+    if (_storage == Storage::Map) {
+        for (const auto &[index, data] : _cache)
+            add(index, index + data.size());
+        return ranges;
+    }
+
+    // Walk the window, alternating between runs of missing and present bytes
+    size_t found = 0;
+    uint64_t i = unassembled();
+    while (found < _unass_bytes && i < win_end()) {
+        const size_t pos = i % _capacity;
+        const size_t limit = min(win_end() - i, uint64_t{_capacity - pos});
+        const size_t gap = bitmap_run(pos, limit, false);
+        const size_t run = gap < limit ? bitmap_run(pos + gap, limit - gap) : 0;
+        if (run)
+            add(i + gap, i + gap + run);
+        found += run;
+        i += gap + run;
+    }
+    return ranges;
+}
+
+size_t StreamReassembler::fragments() const {
+    return _storage == Storage::Map ? _cache.size() : held_ranges().size();
 }
 
 //! \details This function accepts a substring (aka a segment) of bytes,
 //! possibly out-of-order, from the logical stream, and assembles any newly
 //! contiguous substrings and writes them into the output stream in order.
-/*template <typename T>
-void StreamReassembler::push_substring(T &&data, const size_t index, const bool eof);*/
\ No newline at end of file
+//! A segment that arrives in order while nothing is held skips the cache entirely.
+void StreamReassembler::push_substring(const Buffer &data, const size_t index, const bool eof) {
+    if (eof)
+        _eof = index + data.size();
+
+    decltype(_cache)::iterator it;
+    if (!_unass_bytes && index <= unassembled()) {
+        // Fast path: nothing is held and `data` continues the stream, so write it
+        // straight out. The output's remaining capacity is exactly the window.
+        if (index + data.size() > unassembled())
+            assemble(index == unassembled() ? data : data.substr(unassembled() - index, data.size()));
+    } else if (_storage == Storage::Bitmap) {
+        if (data.size()) {
+            bitmap_push(index, data);
+            bitmap_assemble();
+        }
+    } else if (data.size() && cache_push(index, data)) {
+        while (_cache.size() && (it = _cache.begin())->first <= unassembled()) {
+            assemble(it->second);
+            __cache_del(it);
+        }
+        cache_limit(index, index + data.size());
+    }
+
+    if (unassembled() == _eof)
+        _output.end_input();
+}
@@ -1,24 +1,37 @@
 #ifndef SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
 #define SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
 
+#include "buffer.hh"
 #include "byte_stream.hh"
-#include "string_buffer.hh"
 
 #include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 //! \brief A class that assembles a series of excerpts from a byte stream (possibly out of order,
 //! possibly overlapping) into an in-order byte stream.
 class StreamReassembler {
+  public:
+    //! How the reassembler holds bytes that arrived ahead of a hole
+    //! \note Bitmap storage copies each held byte into its ring, so holding out-of-order bytes
+    //! never allocates; but each run that becomes contiguous is copied again, into a pooled
+    //! Buffer, as it is written to the output stream.
+    enum class Storage {
+        Map,    //!< A map from stream index to the received Buffer; shares segment payloads
+        Bitmap  //!< A capacity-sized ring of bytes plus a bitmap of which have arrived
+    };
+
   private:
     // Your code here -- add private members as necessary.
 
     ByteStream _output;  //!< The reassembled in-order byte stream
     size_t _capacity;    //!< The maximum number of bytes
-    std::map<uint64_t, StringBuffer> _cache{};
+    std::map<uint64_t, Buffer> _cache{};
     size_t _unass_bytes{}, _eof;
-    size_t assemble(const StringBuffer &data) { return _output.write(data); }
+    size_t _max_fragments;  //!< Most fragments held in Map mode (0 means no limit)
+    size_t assemble(const Buffer &data) { return _output.write(data); }
     uint64_t unassembled() const { return _output.bytes_written(); }
     uint64_t win_end() const { return _output.bytes_read() + _capacity; }
     template <typename T>
@@ -30,14 +43,26 @@ class StreamReassembler {
         _unass_bytes -= it->second.size();
         _cache.erase(it);
     }
-    bool cache_push(const uint64_t index, const std::string &data);
-    bool cache_push(const uint64_t index, std::string &&data);
+    bool cache_push(const uint64_t index, const Buffer &data);
+    void cache_limit(const uint64_t first, const uint64_t last);
+
+    Storage _storage;
+    std::string _ring{};              //!< Bitmap mode: the byte with stream index `i` lives at `i % _capacity`
+    std::vector<uint64_t> _bitmap{};  //!< Bitmap mode: bit `i % _capacity` is set once byte `i` has arrived
+    size_t bitmap_mark(size_t pos, size_t len, const bool present);
+    size_t bitmap_run(const size_t pos, const size_t max_len, const bool present = true) const;
+    void bitmap_push(const uint64_t index, const Buffer &data);
+    void bitmap_assemble();
 
   public:
     //! \brief Construct a `StreamReassembler` that will store up to `capacity` bytes.
     //! \note This capacity limits both the bytes that have been reassembled,
     //! and those that have not yet been reassembled.
-    StreamReassembler(const size_t capacity);
+    //! \param max_fragments caps how many separate fragments Map storage may hold (0 means no limit).
+    //! Past the cap, the fragments touching the bytes just pushed are coalesced into one, and if
+    //! that isn't enough the fragments furthest from the next expected byte are dropped. Those
+    //! bytes were never acknowledged, so the peer will resend them.
+    StreamReassembler(const size_t capacity, const Storage storage = Storage::Map, const size_t max_fragments = 0);
 
     //! \brief Receive a substring and write any newly contiguous bytes into the stream.
     //!
@@ -47,23 +72,26 @@ class StreamReassembler {
     //! \param data the substring
     //! \param index indicates the index (place in sequence) of the first byte in `data`
     //! \param eof the last byte of `data` will be the last byte in the entire stream
-    template <typename T>
-    void push_substring(T &&data, const size_t index, const bool eof) {
-        if (eof)
-            _eof = index + data.size();
-
-        decltype(_cache)::iterator it;
-        if (data.size() && cache_push(index, std::forward<T>(data))) {
-            while (_cache.size() && (it = _cache.begin())->first <= unassembled()) {
-                assemble(it->second);
-                __cache_del(it);
-            }
-        }
-
-        if (unassembled() == _eof)
-            _output.end_input();
+    //! \note With Map storage, and for in-order data, the stored bytes share `data`'s storage;
+    //! nothing is copied until the reader consumes them from the output stream. Bitmap
+    //! storage copies out-of-order bytes (see Storage). The `const std::string &` overload
+    //! copies `data` into a pooled Buffer first.
+    void push_substring(const Buffer &data, const size_t index, const bool eof);
+    void push_substring(std::string &&data, const size_t index, const bool eof) {
+        push_substring(Buffer{std::move(data)}, index, eof);
+    }
+    void push_substring(const std::string &data, const size_t index, const bool eof) {
+        push_substring(Buffer::copy_from(data), index, eof);
     }
 
+    //! \brief Raise the capacity to `capacity` bytes (a smaller value leaves it as it is)
+    //! \details The output stream grows with it. Bitmap storage moves the held bytes into a
+    //! ring and bitmap of the new size.
+    void grow(const size_t capacity);
+
+    //! The most bytes held at once, reassembled or not
+    size_t capacity() const noexcept { return _capacity; }
+
     //! \name Access the reassembled byte stream
     //!@{
     const ByteStream &stream_out() const noexcept { return _output; }
@@ -76,9 +104,19 @@ class StreamReassembler {
     //! should only be counted once for the purpose of this function.
     size_t unassembled_bytes() const noexcept { return _unass_bytes; }
 
+    //! \brief The byte ranges held but not yet reassembled, as [first, last) stream indices
+    //! \details Ranges are in increasing order; touching fragments are reported as one range.
+    std::vector<std::pair<uint64_t, uint64_t>> held_ranges() const;
+
+    //! The number of separately stored fragments (for Bitmap storage, the number of held ranges)
+    size_t fragments() const;
+
     //! \brief Is the internal state empty (other than the output stream)?
     //! \returns `true` if no substrings are waiting to be assembled
-    bool empty() const noexcept { return _cache.empty(); }
+    bool empty() const noexcept { return _unass_bytes == 0; }
+
+    //! How out-of-order bytes are held
+    Storage storage() const noexcept { return _storage; }
 };
 
 #endif  // SPONGE_LIBSPONGE_STREAM_REASSEMBLER_HH
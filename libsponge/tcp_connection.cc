@@ -1,5 +1,6 @@
 #include "tcp_connection.hh"
 
+#include <cmath>
 #include <iostream>
 
 using namespace std;
@@ -13,22 +14,55 @@ void TCPConnection::segment_received(const TCPSegment &seg) {
         return;
     }
 
+    // the peer's SYN settles the MSS and whether windows are scaled and timestamps used (RFC 7323)
+    if (seg.header().syn && !_receiver.syn_rcvd()) {
+        if (seg.header().options.mss)
+            _sender.limit_mss(*seg.header().options.mss);
+        if (_cfg.window_scaling && seg.header().options.wscale)
+            _snd_wscale = min(*seg.header().options.wscale, TCPConfig::MAX_WINDOW_SCALE);
+        if (_cfg.timestamps && seg.header().options.timestamps) {
+            _timestamps = true;
+            _receiver.enable_timestamps();
+
+            // the MSS bounds payload and options together (RFC 6691), and every segment now carries timestamps
+            TCPOptions with_timestamps;
+            with_timestamps.timestamps = TCPOptions::Timestamps{};
+            _sender.limit_mss(_sender.mss() - with_timestamps.length());
+        }
+    }
+
+    // an old duplicate, by its timestamp, is only acknowledged (PAWS, RFC 7323)
+    if (_receiver.old_duplicate(seg)) {
+        _sender.send_empty_segment();
+        _sender_flush();
+        return;
+    }
+
     bool need_flush = false;
     if (seg.header().ack) {
         if (!_sender.syn_sent())
             return;
 
-        _sender.ack_received(seg.header().ackno, seg.header().win);
+        const uint8_t shift = _snd_wscale.has_value() && !seg.header().syn ? *_snd_wscale : 0;
+        const auto &ts = seg.header().options.timestamps;
+        _sender.ack_received(seg.header().ackno,
+                             uint64_t{seg.header().win} << shift,
+                             seg.length_in_sequence_space() == 0,
+                             _timestamps && ts ? optional<uint32_t>{ts->ecr} : nullopt);
         _sender.fill_window();
         need_flush = true;
     }
 
+    const bool held_none = _receiver.unassembled_bytes() == 0;
+    const uint64_t ackno_before = _receiver.ackno_absolute();
     _receiver.segment_received(seg);
     _time_since_last_segment_received = 0;
 
     if (seg.length_in_sequence_space()) {
+        const bool in_order = held_none && _receiver.unassembled_bytes() == 0 &&
+                              _receiver.ackno_absolute() == ackno_before + seg.length_in_sequence_space();
         _sender.fill_window();
-        if (_sender.segments_out().empty())
+        if (_sender.segments_out().empty() && !_delay_ack(seg, in_order))
             _sender.send_empty_segment();
         need_flush = true;
     } else if (_receiver.syn_rcvd() && seg.header().seqno == _receiver.ackno().value() - 1) {
@@ -43,6 +77,31 @@ void TCPConnection::segment_received(const TCPSegment &seg) {
         _linger_after_streams_finish = false;
 }
 
+//! \details Only in-order data waits, and only until two full segments' worth is unacknowledged
+//! or the delay runs out; a full segment is the MSS in use, which the peer's SYN may have lowered.
+//! SYNs and FINs, data that arrives out of order, and data that fills a hole are acknowledged at
+//! once, as the peer's loss recovery depends on those ACKs.
+bool TCPConnection::_delay_ack(const TCPSegment &seg, const bool in_order) {
+    if (!_cfg.delayed_ack || !in_order || seg.header().syn || seg.header().fin)
+        return false;
+
+    _unacked_bytes += seg.payload().size();
+    if (_unacked_bytes >= 2 * _sender.mss())
+        return false;
+    if (!_ack_pending) {
+        _ack_pending = true;
+        _ack_timer = min(_cfg.ack_delay, TCPConfig::MAX_ACK_DELAY);
+    }
+    return true;
+}
+
+uint8_t TCPConnection::_window_scale_for(const size_t capacity) {
+    uint8_t shift = 0;
+    while (shift < TCPConfig::MAX_WINDOW_SCALE && (capacity >> shift) > UINT16_MAX)
+        ++shift;
+    return shift;
+}
+
 //! \brief Is the connection still alive in any way?
 //! \returns `true` if either stream is still running or if the TCPConnection is lingering
 //! after both streams have finished (e.g. to ACK retransmissions from the peer)
@@ -66,6 +125,13 @@ size_t TCPConnection::write(const string &data) {
     return res;
 }
 
+size_t TCPConnection::write(string &&data) {
+    size_t res = outbound_stream().write(move(data));
+    _sender.fill_window();
+    _sender_flush();
+    return res;
+}
+
 //! \param[in] ms_since_last_tick number of milliseconds since the last call to this method
 void TCPConnection::tick(const size_t ms_since_last_tick) {
     if (!active())
@@ -80,6 +146,18 @@ void TCPConnection::tick(const size_t ms_since_last_tick) {
         return;
     }
 
+    const RTTEstimator &rtt = _sender.rtt();
+    _receiver.tune_window(ms_since_last_tick, rtt.has_sample() ? max<uint64_t>(llround(rtt.srtt()), 1) : 0);
+
+    if (_ack_pending) {
+        if (_ack_timer <= ms_since_last_tick) {
+            if (_sender.segments_out().empty())
+                _sender.send_empty_segment();
+        } else {
+            _ack_timer -= ms_since_last_tick;
+        }
+    }
+
     _sender_flush();
 }
 
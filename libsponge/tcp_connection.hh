@@ -10,8 +10,22 @@
 class TCPConnection {
   private:
     TCPConfig _cfg;
-    TCPReceiver _receiver{_cfg.recv_capacity};
-    TCPSender _sender{_cfg.send_capacity, _cfg.rt_timeout, _cfg.fixed_isn};
+    TCPReceiver _receiver{_cfg.recv_capacity,
+                          _cfg.reassembly,
+                          _cfg.reassembly_fragments,
+                          _cfg.recv_autotune ? _cfg.recv_capacity_max : 0};
+    TCPSender _sender{_cfg};
+
+    //! the window scale shift we apply to the windows we advertise, the least that fits the
+    //! receiver's greatest capacity
+    uint8_t _rcv_wscale{_window_scale_for(_receiver.capacity_max())};
+
+    //! the peer's window scale shift; set only once both SYNs carry the option, as windows
+    //! are unscaled in both directions otherwise
+    std::optional<uint8_t> _snd_wscale{};
+
+    //! whether both SYNs carried timestamps (RFC 7323), so every segment does
+    bool _timestamps{false};
 
     //! outbound queue of segments that the TCPConnection wants sent
     std::queue<TCPSegment> _segments_out{};
@@ -23,6 +37,11 @@ class TCPConnection {
 
     size_t _time_since_last_segment_received{};
 
+    //! whether an ACK is being delayed, the milliseconds until it must go, and the bytes it will cover
+    bool _ack_pending{false};
+    size_t _ack_timer{0};
+    size_t _unacked_bytes{0};
+
     bool _error{false};
 
     bool _active{true};
@@ -42,18 +61,45 @@ class TCPConnection {
             __set_ack(seg);
             segments_out().push(std::move(seg));
             seg_out.pop();
+
+            // whatever we send acknowledges all we have received
+            if (_receiver.syn_rcvd()) {
+                _receiver.ack_sent();
+                _ack_pending = false;
+                _unacked_bytes = 0;
+            }
         }
     }
 
+    //! whether the ACK for `seg` may be delayed (if so, starts the delay); `in_order` says whether the
+    //! segment arrived in order and left no hole behind
+    bool _delay_ack(const TCPSegment &seg, const bool in_order);
+
     void __set_ack(TCPSegment &seg) const {
         auto ackno = _receiver.ackno();
         if (ackno.has_value()) {
             seg.header().ack = true;
             seg.header().ackno = ackno.value();
-            seg.header().win = std::min(static_cast<size_t>(UINT16_MAX), _receiver.window_size());
+            // the window in a SYN is never scaled
+            const uint8_t shift = _snd_wscale.has_value() && !seg.header().syn ? _rcv_wscale : 0;
+            seg.header().win = std::min(static_cast<size_t>(UINT16_MAX), _receiver.window_size() >> shift);
         }
+        // offer timestamps on our SYN, or accept the peer's offer on the SYN/ACK
+        if (_timestamps || (seg.header().syn && _cfg.timestamps && !_receiver.syn_rcvd())) {
+            seg.header().options.timestamps =
+                TCPOptions::Timestamps{_sender.ts_val(), _receiver.ts_recent().value_or(0)};
+        }
+        if (!seg.header().syn)
+            return;
+        seg.header().options.mss = static_cast<uint16_t>(std::min(_cfg.mss, static_cast<size_t>(UINT16_MAX)));
+        // offer window scaling on our SYN, or accept the peer's offer on the SYN/ACK
+        if (_cfg.window_scaling && (!_receiver.syn_rcvd() || _snd_wscale.has_value()))
+            seg.header().options.wscale = _rcv_wscale;
     }
 
+    //! the least window scale shift that lets a window of `capacity` bytes be advertised
+    static uint8_t _window_scale_for(const size_t capacity);
+
     void _set_error() {
         outbound_stream().set_error();
         inbound_stream().set_error();
@@ -133,6 +179,17 @@ class TCPConnection {
     //! \brief Write data to the outbound byte stream, and send it over TCP if possible
     //! \returns the number of bytes from `data` that were actually written.
     size_t write(const std::string &data);
+    size_t write(std::string &&data);
+
+    //! \brief Hold back segments smaller than the MSS, so small writes coalesce, until uncork()
+    void cork() { _sender.set_corked(true); }
+
+    //! \brief Stop holding back small segments, and send what was held
+    void uncork() {
+        _sender.set_corked(false);
+        _sender.fill_window();
+        _sender_flush();
+    }
 
     //! \returns the number of `bytes` that can be written right now.
     size_t remaining_outbound_capacity() const { return outbound_stream().remaining_capacity(); }
@@ -159,6 +216,8 @@ class TCPConnection {
     //!@{
     //! \brief number of bytes sent and not yet acknowledged, counting SYN/FIN each as one byte
     size_t bytes_in_flight() const { return _sender.bytes_in_flight(); }
+    //! \brief the sender's round-trip time estimate (SRTT, RTTVAR and the RTO they imply)
+    const RTTEstimator &rtt() const { return _sender.rtt(); }
     //! \brief number of bytes not yet reassembled
     size_t unassembled_bytes() const { return _receiver.unassembled_bytes(); }
     //! \brief Number of milliseconds since the last segment was received
@@ -176,6 +235,10 @@ class TCPConnection {
     //! Called periodically when time elapses
     void tick(const size_t ms_since_last_tick);
 
+    //! \brief Milliseconds until the sender's pacer lets out more data (0 if it isn't holding any),
+    //! so the owner can call tick() then rather than wait for its next periodic one
+    uint64_t pacing_delay() const { return _sender.pacing_delay(); }
+
     //! \brief TCPSegments that the TCPConnection has enqueued for transmission.
     //! \note The owner or operating system will dequeue these and
     //! put each one into the payload of a lower-layer datagram (usually Internet datagrams (IP),
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -47,10 +48,34 @@ optional<TCPSegment> TCPOverUDPSocketAdapter::read() {
 
 //! Serialize a TCP segment and send it as the payload of a UDP datagram.
 //! \param[in] seg is the TCP segment to write
+//! \details A super-segment is split into pieces, each with its own header and checksum.
+//! Every piece but the last has the same length, so the kernel can send them all in one
+//! system call and cut them apart (see UDPSocket::sendto_segmented()); failing that, they go
+//! out one datagram at a time.
 void TCPOverUDPSocketAdapter::write(TCPSegment &seg) {
     seg.header().sport = config().source.port();
     seg.header().dport = config().destination.port();
-    _sock.sendto(config().destination, seg.serialize(0));
+
+    if (not seg.is_super_segment()) {
+        _sock.sendto(config().destination, seg.serialize(0));
+        return;
+    }
+
+    vector<BufferList> pieces;
+    BufferViewList all_pieces;
+    seg.split([&](TCPSegment &piece) { pieces.push_back(piece.serialize(0)); });
+    for (const auto &piece : pieces) {
+        for (const auto &buffer : piece.buffers()) {
+            all_pieces.append(buffer);
+        }
+    }
+
+    if (_sock.sendto_segmented(config().destination, all_pieces, seg.header().length() + seg.gso_size())) {
+        return;
+    }
+    for (const auto &piece : pieces) {
+        _sock.sendto(config().destination, piece);
+    }
 }
 
 //! Specialize LossyFdAdapter to TCPOverUDPSocketAdapter
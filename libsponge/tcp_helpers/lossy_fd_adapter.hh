@@ -49,7 +49,12 @@ class LossyFdAdapter {
 
     //! \brief Write to the underlying AdapterT instance, potentially dropping the datagram to be written
     //! \param[in] seg is the packet to either write or drop
+    //! \note With loss enabled, each piece of a super-segment is written or dropped on its own.
     void write(TCPSegment &seg) {
+        if (seg.is_super_segment() and _adapter.config().loss_rate_up != 0) {
+            seg.split([&](TCPSegment &piece) { write(piece); });
+            return;
+        }
         if (_should_drop(true)) {
             return;
         }
@@ -2,6 +2,10 @@
 #define SPONGE_LIBSPONGE_TCP_CONFIG_HH
 
 #include "address.hh"
+#include "congestion_control.hh"
+#include "ipv4_header.hh"
+#include "stream_reassembler.hh"
+#include "tcp_header.hh"
 #include "wrapping_integers.hh"
 
 #include <cstddef>
@@ -12,14 +16,71 @@
 class TCPConfig {
   public:
     static constexpr size_t DEFAULT_CAPACITY = 64000;  //!< Default capacity
+    static constexpr size_t AUTOTUNE_MAX = 4 << 20;    //!< Default upper bound of an auto-tuned receive capacity
     static constexpr size_t MAX_PAYLOAD_SIZE = 1000;   //!< Conservative max payload size for real Internet
+    static constexpr size_t MIN_MSS = 88;              //!< Smallest MSS a peer can ask for (smaller ones are raised)
     static constexpr uint16_t TIMEOUT_DFLT = 1000;     //!< Default re-transmit timeout is 1 second
     static constexpr unsigned MAX_RETX_ATTEMPTS = 8;   //!< Maximum re-transmit attempts before giving up
+    static constexpr unsigned DUP_ACK_THRESHOLD = 3;   //!< Duplicate acks that trigger a fast retransmit
+    static constexpr uint16_t RTO_MIN_DFLT = 10;       //!< Default lower bound of an adaptive timeout, in milliseconds
+    static constexpr uint16_t RTO_MAX_DFLT = 60000;    //!< Default upper bound of an adaptive timeout, in milliseconds
+    static constexpr uint8_t MAX_WINDOW_SCALE = 14;    //!< Largest window scale shift (RFC 7323)
+    static constexpr uint16_t MAX_ACK_DELAY = 200;     //!< Longest a receiver may delay an ACK, in milliseconds
+    static constexpr uint16_t ACK_DELAY_DFLT = 40;     //!< Default delayed-ACK timeout, in milliseconds
 
     uint16_t rt_timeout = TIMEOUT_DFLT;       //!< Initial value of the retransmission timeout, in milliseconds
     size_t recv_capacity = DEFAULT_CAPACITY;  //!< Receive capacity, in bytes
     size_t send_capacity = DEFAULT_CAPACITY;  //!< Sender capacity, in bytes
+
+    //! Whether the receive window follows how fast the application reads, from recv_capacity
+    //! (its least and first value) up to recv_capacity_max, rather than staying at recv_capacity
+    //! (windows past 64 KiB can only be advertised with window_scaling)
+    bool recv_autotune = false;
+    size_t recv_capacity_max = AUTOTUNE_MAX;  //!< Greatest auto-tuned receive capacity, in bytes
+
     std::optional<WrappingInt32> fixed_isn{};
+
+    //! Largest payload to receive, advertised in the SYN's MSS option. Segments sent carry at
+    //! most this or the peer's MSS, whichever is less (a peer that sends no MSS option gets this).
+    size_t mss = MAX_PAYLOAD_SIZE;
+
+    //! The MSS that fills a link of the given MTU with TCP over IPv4 (without options)
+    static constexpr size_t mss_for_mtu(const size_t mtu) { return mtu - IPv4Header::LENGTH - TCPHeader::LENGTH; }
+
+    //! Most MSS-sized pieces the sender puts in one super-segment, split at the adapter like GSO
+    //! (1 means every segment is sent as is)
+    size_t gso_segments = 1;
+
+    bool fast_retransmit = false;  //!< Whether duplicate acks trigger fast retransmit and recovery
+
+    //! Whether losses are detected by time as well (RACK), and a tail loss probe is sent when
+    //! acks stop arriving well before the retransmission timeout would fire (TLP, RFC 8985)
+    bool rack_tlp = false;
+    bool window_scaling = false;   //!< Whether to offer window scaling (RFC 7323), so windows can exceed 64 KiB
+    bool timestamps = false;       //!< Whether to offer timestamps (RFC 7323), for RTT samples and PAWS
+    bool nagle = false;            //!< Whether to hold back small segments while data is unacknowledged (RFC 896)
+
+    //! Whether in-order data is acknowledged only every second full segment, or once ack_delay has
+    //! passed, rather than segment by segment (RFC 1122, RFC 5681)
+    bool delayed_ack = false;
+    uint16_t ack_delay = ACK_DELAY_DFLT;  //!< Longest an ACK is delayed, in milliseconds (at most MAX_ACK_DELAY)
+
+    //! Whether the sender spreads segments over each round trip, at a rate that sends the window
+    //! once per smoothed RTT, instead of sending the whole window at once
+    bool pacing = false;
+    uint64_t pacing_rate_max = 0;  //!< Cap on the pacing rate, in bytes per second (0 means no cap)
+
+    //! Whether the retransmission timeout follows the measured RTT (RFC 6298) instead of starting at rt_timeout
+    bool adaptive_rto = false;
+    uint16_t rto_min = RTO_MIN_DFLT;  //!< Least adaptive retransmission timeout, in milliseconds
+    uint16_t rto_max = RTO_MAX_DFLT;  //!< Greatest adaptive retransmission timeout, after backoff, in milliseconds
+
+    //! Congestion control for the sender (None: only the receiver's window limits sending)
+    CongestionControl::Algorithm congestion_control = CongestionControl::Algorithm::None;
+
+    //! How the receiver holds out-of-order bytes (Bitmap trades a copy per byte for allocation-free reassembly)
+    StreamReassembler::Storage reassembly = StreamReassembler::Storage::Map;
+    size_t reassembly_fragments = 0;  //!< Most out-of-order fragments the receiver holds at once (0 means no limit)
 };
 
 //! Config for classes derived from FdAdapter
@@ -28,6 +89,8 @@ class FdAdapterConfig {
     Address source{"0", 0};       //!< Source address and port
     Address destination{"0", 0};  //!< Destination address and port
 
+    uint16_t mtu = 1500;  //!< MTU of the link the adapter sends on
+
     uint16_t loss_rate_dn = 0;  //!< Downlink loss rate (for LossyFdAdapter)
     uint16_t loss_rate_up = 0;  //!< Uplink loss rate (for LossyFdAdapter)
 };
@@ -1,9 +1,165 @@
 #include "tcp_header.hh"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace std;
 
+//! \name Option kinds
+//!@{
+static constexpr uint8_t OPT_EOL = 0;             //!< end of option list
+static constexpr uint8_t OPT_NOP = 1;             //!< no-operation (padding)
+static constexpr uint8_t OPT_MSS = 2;             //!< maximum segment size
+static constexpr uint8_t OPT_WSCALE = 3;          //!< window scale
+static constexpr uint8_t OPT_SACK_PERMITTED = 4;  //!< SACK permitted
+static constexpr uint8_t OPT_SACK = 5;            //!< SACK blocks
+static constexpr uint8_t OPT_TIMESTAMPS = 8;      //!< timestamps
+//!@}
+
+//! \param[in] bytes are the option bytes following the fixed header
+//! \details Options with a length that doesn't match their kind are skipped; a
+//! malformed length ends the list, as it leaves no way to find the next option.
+void TCPOptions::parse(const string_view bytes) {
+    *this = {};
+
+    const auto u8 = [&](const size_t i) { return static_cast<uint8_t>(bytes[i]); };
+    const auto u16 = [&](const size_t i) { return static_cast<uint16_t>(u8(i) << 8 | u8(i + 1)); };
+    const auto u32 = [&](const size_t i) { return static_cast<uint32_t>(u16(i)) << 16 | u16(i + 2); };
+
+    for (size_t i = 0; i < bytes.size();) {
+        const uint8_t kind = u8(i);
+        if (kind == OPT_EOL)
+            break;
+        if (kind == OPT_NOP) {
+            ++i;
+            continue;
+        }
+
+        if (i + 1 >= bytes.size())
+            break;
+        const uint8_t len = u8(i + 1);
+        if (len < 2 || i + len > bytes.size())
+            break;
+
+        switch (kind) {
+            case OPT_MSS:
+                if (len == 4)
+                    mss = u16(i + 2);
+                break;
+            case OPT_WSCALE:
+                if (len == 3)
+                    wscale = u8(i + 2);
+                break;
+            case OPT_SACK_PERMITTED:
+                sack_permitted = (len == 2);
+                break;
+            case OPT_SACK:
+                if ((len - 2) % 8 == 0)
+                    for (size_t b = i + 2; b < i + len; b += 8)
+                        add_sack_block(WrappingInt32{u32(b)}, WrappingInt32{u32(b + 4)});
+                break;
+            case OPT_TIMESTAMPS:
+                if (len == 10)
+                    timestamps = Timestamps{u32(i + 2), u32(i + 6)};
+                break;
+            default:
+                break;
+        }
+        i += len;
+    }
+}
+
+//! \details Lays the options out the way common stacks do, using NOPs rather than trailing
+//! padding so every option is aligned: MSS, SACK-permitted and timestamps, window scale.
+size_t TCPOptions::base_length() const {
+    size_t len = (mss ? 4 : 0) + (wscale ? 4 : 0);
+    if (timestamps)
+        len += 12;  // SACK-permitted, if set, takes the place of the two NOPs before timestamps
+    else if (sack_permitted)
+        len += 4;
+    return len;
+}
+
+size_t TCPOptions::sack_blocks_sent() const {
+    const size_t room = MAX_LENGTH - base_length();
+    return room >= 4 + 8 ? min<size_t>(sack_count, (room - 4) / 8) : 0;
+}
+
+size_t TCPOptions::length() const {
+    const size_t blocks = sack_blocks_sent();
+    return base_length() + (blocks ? 4 + 8 * blocks : 0);
+}
+
+void TCPOptions::serialize(string &out) const {
+    if (mss) {
+        NetUnparser::u8(out, OPT_MSS);
+        NetUnparser::u8(out, 4);
+        NetUnparser::u16(out, *mss);
+    }
+
+    if (timestamps) {
+        NetUnparser::u8(out, sack_permitted ? OPT_SACK_PERMITTED : OPT_NOP);
+        NetUnparser::u8(out, sack_permitted ? 2 : OPT_NOP);
+        NetUnparser::u8(out, OPT_TIMESTAMPS);
+        NetUnparser::u8(out, 10);
+        NetUnparser::u32(out, timestamps->val);
+        NetUnparser::u32(out, timestamps->ecr);
+    } else if (sack_permitted) {
+        NetUnparser::u8(out, OPT_NOP);
+        NetUnparser::u8(out, OPT_NOP);
+        NetUnparser::u8(out, OPT_SACK_PERMITTED);
+        NetUnparser::u8(out, 2);
+    }
+
+    if (wscale) {
+        NetUnparser::u8(out, OPT_NOP);
+        NetUnparser::u8(out, OPT_WSCALE);
+        NetUnparser::u8(out, 3);
+        NetUnparser::u8(out, *wscale);
+    }
+
+    if (const size_t blocks = sack_blocks_sent(); blocks) {
+        NetUnparser::u8(out, OPT_NOP);
+        NetUnparser::u8(out, OPT_NOP);
+        NetUnparser::u8(out, OPT_SACK);
+        NetUnparser::u8(out, 2 + 8 * blocks);
+        for (size_t i = 0; i < blocks; ++i) {
+            NetUnparser::u32(out, sack_blocks[i].left.raw_value());
+            NetUnparser::u32(out, sack_blocks[i].right.raw_value());
+        }
+    }
+}
+
+void TCPOptions::add_sack_block(const WrappingInt32 left, const WrappingInt32 right) {
+    if (sack_count < MAX_SACK_BLOCKS)
+        sack_blocks[sack_count++] = {left, right};
+}
+
+//! \returns A string with the options present, e.g. "mss=1460 sackok ts=5/0 wscale=7"
+string TCPOptions::to_string() const {
+    stringstream ss{};
+    if (mss)
+        ss << " mss=" << *mss;
+    if (sack_permitted)
+        ss << " sackok";
+    if (timestamps)
+        ss << " ts=" << timestamps->val << '/' << timestamps->ecr;
+    if (wscale)
+        ss << " wscale=" << +*wscale;
+    for (size_t i = 0; i < sack_count; ++i)
+        ss << " sack=[" << sack_blocks[i].left << ',' << sack_blocks[i].right << ')';
+    const string ret = ss.str();
+    return ret.empty() ? ret : ret.substr(1);
+}
+
+bool TCPOptions::operator==(const TCPOptions &other) const {
+    return mss == other.mss && wscale == other.wscale && sack_permitted == other.sack_permitted &&
+           timestamps == other.timestamps && sack_count == other.sack_count &&
+           equal(sack_blocks.begin(), sack_blocks.begin() + sack_count, other.sack_blocks.begin());
+}
+
+size_t TCPHeader::length() const { return 4 * max<size_t>(doff, (LENGTH + options.length()) / 4); }
+
 //! \param[in,out] p is a NetParser from which the TCP fields will be extracted
 //! \returns a ParseResult indicating success or the reason for failure
 //! \details It is important to check for (at least) the following potential errors
@@ -37,8 +193,14 @@ ParseResult TCPHeader::parse(NetParser &p) {
         return ParseResult::HeaderTooShort;
     }
 
-    // skip any options or anything extra in the header
-    p.remove_prefix(doff * 4 - TCPHeader::LENGTH);
+    // parse the options, then skip past them and anything else extra in the header
+    const size_t options_len = doff * 4 - TCPHeader::LENGTH;
+    if (!p.error() && p.buffer().size() >= options_len) {
+        options.parse(p.buffer().str().substr(0, options_len));
+    } else {
+        options = {};
+    }
+    p.remove_prefix(options_len);
 
     if (p.error()) {
         return p.get_error();
@@ -54,14 +216,15 @@ string TCPHeader::serialize() const {
         throw runtime_error("TCP header too short");
     }
 
+    const size_t len = length();
     string ret;
-    ret.reserve(4 * doff);
+    ret.reserve(len);
 
     NetUnparser::u16(ret, sport);              // source port
     NetUnparser::u16(ret, dport);              // destination port
     NetUnparser::u32(ret, seqno.raw_value());  // sequence number
     NetUnparser::u32(ret, ackno.raw_value());  // ack number
-    NetUnparser::u8(ret, doff << 4);           // data offset
+    NetUnparser::u8(ret, len / 4 << 4);        // data offset, raised to fit the options
 
     const uint8_t fl_b = (urg ? 0b0010'0000 : 0) | (ack ? 0b0001'0000 : 0) | (psh ? 0b0000'1000 : 0) |
                          (rst ? 0b0000'0100 : 0) | (syn ? 0b0000'0010 : 0) | (fin ? 0b0000'0001 : 0);
@@ -72,7 +235,9 @@ string TCPHeader::serialize() const {
 
     NetUnparser::u16(ret, uptr);  // urgent pointer
 
-    ret.resize(4 * doff);  // expand header to advertised size
+    options.serialize(ret);  // options
+
+    ret.resize(len);  // expand header to advertised size
 
     return ret;
 }
@@ -89,7 +254,8 @@ string TCPHeader::to_string() const {
        << " fin: " << fin << '\n'
        << "TCP winsize: " << +win << '\n'
        << "TCP cksum: " << +cksum << '\n'
-       << "TCP uptr: " << +uptr << '\n';
+       << "TCP uptr: " << +uptr << '\n'
+       << "TCP options: " << options.to_string() << '\n';
     return ss.str();
 }
 
@@ -104,5 +270,5 @@ bool TCPHeader::operator==(const TCPHeader &other) const {
     // TODO(aozdemir) more complete check (right now we omit cksum, src, dst
     return seqno == other.seqno && ackno == other.ackno && doff == other.doff && urg == other.urg && ack == other.ack &&
            psh == other.psh && rst == other.rst && syn == other.syn && fin == other.fin && win == other.win &&
-           uptr == other.uptr;
+           uptr == other.uptr && options == other.options;
 }
@@ -4,10 +4,71 @@
 #include "parser.hh"
 #include "wrapping_integers.hh"
 
+#include <array>
+#include <optional>
+#include <string_view>
+
+//! \brief The options a TCP header can carry: MSS, window scale (RFC 7323), SACK (RFC 2018)
+//! and timestamps (RFC 7323)
+//! \details Held by value in fixed-size fields, so parsing and copying never allocate.
+//! Options of other kinds are skipped when parsing and not reproduced.
+struct TCPOptions {
+    static constexpr size_t MAX_LENGTH = 40;      //!< Most option bytes a header can hold
+    static constexpr size_t MAX_SACK_BLOCKS = 4;  //!< Most SACK blocks that fit in the option space
+
+    //! \brief A range of sequence numbers [left, right) the receiver holds above its ackno
+    struct SackBlock {
+        WrappingInt32 left{0};   //!< first sequence number held
+        WrappingInt32 right{0};  //!< sequence number just past the block
+
+        bool operator==(const SackBlock &other) const { return left == other.left && right == other.right; }
+    };
+
+    //! \brief The timestamps option
+    struct Timestamps {
+        uint32_t val = 0;  //!< TSval, the sender's clock
+        uint32_t ecr = 0;  //!< TSecr, the most recent TSval received from the peer
+
+        bool operator==(const Timestamps &other) const { return val == other.val && ecr == other.ecr; }
+    };
+
+    std::optional<uint16_t> mss{};                         //!< maximum segment size (SYN only)
+    std::optional<uint8_t> wscale{};                       //!< window scale shift count (SYN only)
+    bool sack_permitted = false;                           //!< SACK-permitted (SYN only)
+    std::optional<Timestamps> timestamps{};                //!< timestamps
+    std::array<SackBlock, MAX_SACK_BLOCKS> sack_blocks{};  //!< SACK blocks, the first `sack_count` are used
+    uint8_t sack_count = 0;                                //!< number of SACK blocks
+
+    //! Parse the options from the option bytes of a header
+    void parse(std::string_view bytes);
+
+    //! Append the options to `out`, padded to a multiple of four bytes
+    //! \note SACK blocks that don't fit in the option space are left out
+    void serialize(std::string &out) const;
+
+    //! Length of the serialized options in bytes, a multiple of four
+    size_t length() const;
+
+    //! Add a SACK block (ignored if all MAX_SACK_BLOCKS are in use)
+    void add_sack_block(const WrappingInt32 left, const WrappingInt32 right);
+
+    //! Return a string containing the options in human-readable format
+    std::string to_string() const;
+
+    bool operator==(const TCPOptions &other) const;
+
+  private:
+    //! length of the options other than SACK blocks
+    size_t base_length() const;
+
+    //! how many of the SACK blocks fit next to the other options
+    size_t sack_blocks_sent() const;
+};
+
 //! \brief [TCP](\ref rfc::rfc793) segment header
-//! \note TCP options are not supported
 struct TCPHeader {
-    static constexpr size_t LENGTH = 20;  //!< [TCP](\ref rfc::rfc793) header length, not including options
+    static constexpr size_t LENGTH = 20;        //!< [TCP](\ref rfc::rfc793) header length, not including options
+    static constexpr size_t CKSUM_OFFSET = 16;  //!< Offset of the checksum field in a serialized header
 
     //! \struct TCPHeader
     //! ~~~{.txt}
@@ -48,8 +109,13 @@ struct TCPHeader {
     uint16_t win = 0;           //!< window size
     uint16_t cksum = 0;         //!< checksum
     uint16_t uptr = 0;          //!< urgent pointer
+    TCPOptions options{};       //!< options
     //!@}
 
+    //! \brief Length of the serialized header in bytes, options included
+    //! \details `doff` is raised as needed to fit the options when serializing.
+    size_t length() const;
+
     //! Parse the TCP fields from the provided NetParser
     ParseResult parse(NetParser &p);
 
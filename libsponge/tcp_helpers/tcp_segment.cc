@@ -3,6 +3,7 @@
 #include "parser.hh"
 #include "util.hh"
 
+#include <algorithm>
 #include <variant>
 
 using namespace std;
@@ -26,19 +27,37 @@ size_t TCPSegment::length_in_sequence_space() const {
     return payload().str().size() + (header().syn ? 1 : 0) + (header().fin ? 1 : 0);
 }
 
+TCPSegment TCPSegment::piece(const size_t pos, const size_t n) const {
+    TCPSegment ret;
+    ret._header = _header;
+    ret._payload = _payload.substr(pos, min(n, _payload.size() - pos));
+    if (pos > 0) {
+        ret._header.seqno = _header.seqno + static_cast<uint32_t>((_header.syn ? 1 : 0) + pos);
+        ret._header.syn = false;
+    }
+    if (pos + ret._payload.size() < _payload.size()) {
+        ret._header.fin = false;
+        ret._header.psh = false;
+    }
+    return ret;
+}
+
 //! \param[in] datagram_layer_checksum pseudo-checksum from the lower-layer protocol
+//! \details The header is serialized once, and the checksum patched into it.
 BufferList TCPSegment::serialize(const uint32_t datagram_layer_checksum) const {
-    TCPHeader header_out = _header;
-    header_out.cksum = 0;
+    string header_out = _header.serialize();
+    header_out[TCPHeader::CKSUM_OFFSET] = header_out[TCPHeader::CKSUM_OFFSET + 1] = 0;
 
     // calculate checksum -- taken over entire segment
     InternetChecksum check(datagram_layer_checksum);
-    check.add(header_out.serialize());
+    check.add(header_out);
     check.add(_payload);
-    header_out.cksum = check.value();
+    const uint16_t cksum = check.value();
+    header_out[TCPHeader::CKSUM_OFFSET] = static_cast<char>(cksum >> 8);
+    header_out[TCPHeader::CKSUM_OFFSET + 1] = static_cast<char>(cksum & 0xff);
 
     BufferList ret;
-    ret.append(header_out.serialize());
+    ret.append(move(header_out));
     ret.append(_payload);
 
     return ret;
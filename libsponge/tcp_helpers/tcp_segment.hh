@@ -11,6 +11,7 @@ class TCPSegment {
   private:
     TCPHeader _header{};
     Buffer _payload{};
+    size_t _gso_size{0};
 
   public:
     //! \brief Parse the segment from a string
@@ -26,8 +27,35 @@ class TCPSegment {
 
     const Buffer &payload() const { return _payload; }
     Buffer &payload() { return _payload; }
+
+    //! \brief Payload bytes per wire segment, if this is a super-segment to be split before
+    //! it is sent (0 means the segment goes out whole)
+    size_t gso_size() const { return _gso_size; }
+    size_t &gso_size() { return _gso_size; }
     //!@}
 
+    //! \brief Whether the payload is longer than gso_size(), so the segment must be split
+    bool is_super_segment() const { return _gso_size and _payload.size() > _gso_size; }
+
+    //! \brief The part of the segment carrying `n` payload bytes from offset `pos`
+    //! \details The seqno is advanced to match, SYN is kept only at offset 0 and FIN only if
+    //! the piece reaches the end of the payload. The payload shares this segment's storage.
+    TCPSegment piece(const size_t pos, const size_t n) const;
+
+    //! \brief Call `f` on each wire-sized piece of a super-segment, in sequence order, or on
+    //! the segment itself if it isn't one
+    template <typename F>
+    void split(F &&f) {
+        if (not is_super_segment()) {
+            f(*this);
+            return;
+        }
+        for (size_t pos = 0; pos < _payload.size(); pos += _gso_size) {
+            TCPSegment p = piece(pos, _gso_size);
+            f(p);
+        }
+    }
+
     //! \brief Segment's length in sequence space
     //! \note Equal to payload length plus one byte if SYN is set, plus one byte if FIN is set
     size_t length_in_sequence_space() const;
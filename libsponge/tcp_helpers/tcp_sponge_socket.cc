@@ -25,7 +25,13 @@ template <typename AdaptT>
 void TCPSpongeSocket<AdaptT>::_tcp_loop(const function<bool()> &condition) {
     auto base_time = timestamp_ms();
     while (condition()) {
-        auto ret = _eventloop.wait_next_event(TCP_TICK_MS);
+        if (_handoff_in) {
+            _pump_handoff_in();
+        }
+
+        // wake up early when the pacer has data to let out
+        const uint64_t pacing_delay = _tcp.value().pacing_delay();
+        auto ret = _eventloop.wait_next_event(pacing_delay ? min<uint64_t>(pacing_delay, TCP_TICK_MS) : TCP_TICK_MS);
         if (ret == EventLoop::Result::Exit or _abort) {
             break;
         }
@@ -51,8 +57,11 @@ TCPSpongeSocket<AdaptT>::TCPSpongeSocket(pair<FileDescriptor, FileDescriptor> da
 }
 
 template <typename AdaptT>
-void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
-    _tcp.emplace(config);
+void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config, const FdAdapterConfig &adapter_config) {
+    // a segment of the MSS must fit the link, whatever MSS the caller asked for
+    TCPConfig clamped = config;
+    clamped.mss = min(config.mss, TCPConfig::mss_for_mtu(adapter_config.mtu));
+    _tcp.emplace(clamped);
 
     // Set up the event loop
 
@@ -91,64 +100,113 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
                         },
                         [&] { return _tcp->active(); });
 
-    // rule 2: read from pipe into outbound buffer
-    _eventloop.add_rule(
-        _thread_data,
-        Direction::In,
-        [&] {
-            const auto data = _thread_data.read(_tcp->remaining_outbound_capacity());
-            const auto len = data.size();
-            const auto amount_written = _tcp->write(move(data));
-            if (amount_written != len) {
-                throw runtime_error("TCPConnection::write() accepted less than advertised length");
-            }
-
-            if (_thread_data.eof()) {
+    if (_handoff_out) {
+        // rules 2 and 3 when the owner hands data over through in-process streams
+
+        // rule 2: read from the outbound handoff stream into outbound buffer
+        _eventloop.add_rule(
+            _handoff_out->data_event(),
+            Direction::In,
+            [&] {
+                // drain first, so a write that races with this callback leaves the event readable
+                _handoff_out->data_event().drain();
+
+                const auto [first, second] = _handoff_out->peek_spans(_tcp->remaining_outbound_capacity());
+                const auto len = first.size() + second.size();
+                string data;
+                data.reserve(len);
+                data.append(first).append(second);
+                const auto amount_written = _tcp->write(move(data));
+                if (amount_written != len) {
+                    throw runtime_error("TCPConnection::write() accepted less than advertised length");
+                }
+                _handoff_out->pop_output(len);
+
+                if (_handoff_out->eof() or _handoff_out->error()) {
+                    _tcp->end_input_stream();
+                    _outbound_shutdown = true;
+
+                    // debugging output:
+                    cerr << "DEBUG: Outbound stream to " << _datagram_adapter.config().destination.to_string()
+                         << " finished (" << _tcp.value().bytes_in_flight() << " byte"
+                         << (_tcp.value().bytes_in_flight() == 1 ? "" : "s") << " still in flight).\n";
+                } else if (not _handoff_out->buffer_empty()) {
+                    // out of outbound capacity; look again once the TCPConnection has room
+                    _handoff_out->data_event().notify();
+                }
+            },
+            [&] {
+                return (_tcp->active()) and (not _outbound_shutdown) and (_tcp->remaining_outbound_capacity() > 0);
+            });
+
+        // rule 3: once the owner frees space, move more inbound bytes into the inbound handoff stream
+        _eventloop.add_rule(
+            _handoff_in->space_event(),
+            Direction::In,
+            [&] {
+                _handoff_in->space_event().drain();
+                _pump_handoff_in();
+            },
+            [&] { return not _tcp->inbound_stream().buffer_empty(); });
+    } else {
+        // rule 2: read from pipe into outbound buffer
+        _eventloop.add_rule(
+            _thread_data,
+            Direction::In,
+            [&] {
+                auto data = _thread_data.read(_tcp->remaining_outbound_capacity());
+                const auto len = data.size();
+                const auto amount_written = _tcp->write(move(data));
+                if (amount_written != len) {
+                    throw runtime_error("TCPConnection::write() accepted less than advertised length");
+                }
+
+                if (_thread_data.eof()) {
+                    _tcp->end_input_stream();
+                    _outbound_shutdown = true;
+
+                    // debugging output:
+                    cerr << "DEBUG: Outbound stream to " << _datagram_adapter.config().destination.to_string()
+                         << " finished (" << _tcp.value().bytes_in_flight() << " byte"
+                         << (_tcp.value().bytes_in_flight() == 1 ? "" : "s") << " still in flight).\n";
+                }
+            },
+            [&] { return (_tcp->active()) and (not _outbound_shutdown) and (_tcp->remaining_outbound_capacity() > 0); },
+            [&] {
                 _tcp->end_input_stream();
                 _outbound_shutdown = true;
-
-                // debugging output:
-                cerr << "DEBUG: Outbound stream to " << _datagram_adapter.config().destination.to_string()
-                     << " finished (" << _tcp.value().bytes_in_flight() << " byte"
-                     << (_tcp.value().bytes_in_flight() == 1 ? "" : "s") << " still in flight).\n";
-            }
-        },
-        [&] { return (_tcp->active()) and (not _outbound_shutdown) and (_tcp->remaining_outbound_capacity() > 0); },
-        [&] {
-            _tcp->end_input_stream();
-            _outbound_shutdown = true;
-        });
-
-    // rule 3: read from inbound buffer into pipe
-    _eventloop.add_rule(
-        _thread_data,
-        Direction::Out,
-        [&] {
-            ByteStream &inbound = _tcp->inbound_stream();
-            // Write from the inbound_stream into
-            // the pipe, handling the possibility of a partial
-            // write (i.e., only pop what was actually written).
-            const size_t amount_to_write = min(size_t(65536), inbound.buffer_size());
-            const std::string buffer = inbound.peek_output(amount_to_write);
-            const auto bytes_written = _thread_data.write(move(buffer), false);
-            inbound.pop_output(bytes_written);
-
-            if (inbound.eof() or inbound.error()) {
-                _thread_data.shutdown(SHUT_WR);
-                _inbound_shutdown = true;
-
-                // debugging output:
-                cerr << "DEBUG: Inbound stream from " << _datagram_adapter.config().destination.to_string()
-                     << " finished " << (inbound.error() ? "with an error/reset.\n" : "cleanly.\n");
-                if (_tcp.value().state() == TCPState::State::TIME_WAIT) {
-                    cerr << "DEBUG: Waiting for lingering segments (e.g. retransmissions of FIN) from peer...\n";
+            });
+
+        // rule 3: read from inbound buffer into pipe
+        _eventloop.add_rule(
+            _thread_data,
+            Direction::Out,
+            [&] {
+                ByteStream &inbound = _tcp->inbound_stream();
+                // Write from the inbound_stream into
+                // the pipe, handling the possibility of a partial
+                // write (i.e., only pop what was actually written).
+                const size_t amount_to_write = min(size_t(65536), inbound.buffer_size());
+                const auto bytes_written = _thread_data.write(inbound.peek_views(amount_to_write), false);
+                inbound.pop_output(bytes_written);
+
+                if (inbound.eof() or inbound.error()) {
+                    _thread_data.shutdown(SHUT_WR);
+                    _inbound_shutdown = true;
+
+                    // debugging output:
+                    cerr << "DEBUG: Inbound stream from " << _datagram_adapter.config().destination.to_string()
+                         << " finished " << (inbound.error() ? "with an error/reset.\n" : "cleanly.\n");
+                    if (_tcp.value().state() == TCPState::State::TIME_WAIT) {
+                        cerr << "DEBUG: Waiting for lingering segments (e.g. retransmissions of FIN) from peer...\n";
+                    }
                 }
-            }
-        },
-        [&] {
-            return (not _tcp->inbound_stream().buffer_empty()) or
-                   ((_tcp->inbound_stream().eof() or _tcp->inbound_stream().error()) and not _inbound_shutdown);
-        });
+            },
+            [&] {
+                return (not _tcp->inbound_stream().buffer_empty()) or
+                       ((_tcp->inbound_stream().eof() or _tcp->inbound_stream().error()) and not _inbound_shutdown);
+            });
+    }
 
     // rule 4: read outbound segments from TCPConnection and send as datagrams
     _eventloop.add_rule(_datagram_adapter,
@@ -162,6 +220,42 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
                         [&] { return not _tcp->segments_out().empty(); });
 }
 
+template <typename AdaptT>
+void TCPSpongeSocket<AdaptT>::_pump_handoff_in() {
+    ByteStream &inbound = _tcp->inbound_stream();
+    while (not inbound.buffer_empty() and _handoff_in->remaining_capacity() > 0) {
+        inbound.pop_output(_handoff_in->write(inbound.peek_spans(_handoff_in->remaining_capacity()).first));
+    }
+
+    if ((inbound.eof() or inbound.error()) and not _inbound_shutdown) {
+        // the owner sees a clean end only after a clean close, and an error after a reset
+        if (inbound.error()) {
+            _handoff_in->set_error();
+        } else {
+            _handoff_in->end_input();
+        }
+        _inbound_shutdown = true;
+
+        // debugging output:
+        cerr << "DEBUG: Inbound stream from " << _datagram_adapter.config().destination.to_string() << " finished "
+             << (inbound.error() ? "with an error/reset.\n" : "cleanly.\n");
+    }
+}
+
+//! \details Called as the TCP thread exits. An inbound stream that _pump_handoff_in() didn't finish
+//! (the connection was reset or aborted before the peer's FIN) gets an error rather than a clean end,
+//! and the outbound stream always gets one, so an owner waiting for space to write wakes up and stops.
+template <typename AdaptT>
+void TCPSpongeSocket<AdaptT>::_end_handoff() {
+    if (_handoff_in and not _inbound_shutdown) {
+        _handoff_in->set_error();
+        _inbound_shutdown = true;
+    }
+    if (_handoff_out) {
+        _handoff_out->set_error();
+    }
+}
+
 //! \brief Call [socketpair](\ref man2::socketpair) and return connected Unix-domain sockets of specified type
 //! \param[in] type is the type of AF_UNIX sockets to create (e.g., SOCK_SEQPACKET)
 //! \returns a std::pair of connected sockets
@@ -193,6 +287,9 @@ TCPSpongeSocket<AdaptT>::~TCPSpongeSocket() {
 template <typename AdaptT>
 void TCPSpongeSocket<AdaptT>::wait_until_closed() {
     shutdown(SHUT_RDWR);
+    if (_handoff_out) {
+        _handoff_out->end_input();
+    }
     if (_tcp_thread.joinable()) {
         cerr << "DEBUG: Waiting for clean shutdown... ";
         _tcp_thread.join();
@@ -200,6 +297,33 @@ void TCPSpongeSocket<AdaptT>::wait_until_closed() {
     }
 }
 
+//! \param[in] capacity is the capacity of each of the two handoff streams
+template <typename AdaptT>
+void TCPSpongeSocket<AdaptT>::use_stream_handoff(const size_t capacity) {
+    if (_tcp) {
+        throw runtime_error("use_stream_handoff() with TCPConnection already initialized");
+    }
+
+    _handoff_out = make_unique<SPSCByteStream>(capacity);
+    _handoff_in = make_unique<SPSCByteStream>(capacity);
+}
+
+template <typename AdaptT>
+SPSCByteStream &TCPSpongeSocket<AdaptT>::handoff_outbound() {
+    if (not _handoff_out) {
+        throw runtime_error("handoff_outbound() without use_stream_handoff()");
+    }
+    return *_handoff_out;
+}
+
+template <typename AdaptT>
+SPSCByteStream &TCPSpongeSocket<AdaptT>::handoff_inbound() {
+    if (not _handoff_in) {
+        throw runtime_error("handoff_inbound() without use_stream_handoff()");
+    }
+    return *_handoff_in;
+}
+
 //! \param[in] c_tcp is the TCPConfig for the TCPConnection
 //! \param[in] c_ad is the FdAdapterConfig for the FdAdapter
 template <typename AdaptT>
@@ -208,7 +332,7 @@ void TCPSpongeSocket<AdaptT>::connect(const TCPConfig &c_tcp, const FdAdapterCon
         throw runtime_error("connect() with TCPConnection already initialized");
     }
 
-    _initialize_TCP(c_tcp);
+    _initialize_TCP(c_tcp, c_ad);
 
     _datagram_adapter.config_mut() = c_ad;
 
@@ -236,7 +360,7 @@ void TCPSpongeSocket<AdaptT>::listen_and_accept(const TCPConfig &c_tcp, const Fd
         throw runtime_error("listen_and_accept() with TCPConnection already initialized");
     }
 
-    _initialize_TCP(c_tcp);
+    _initialize_TCP(c_tcp, c_ad);
 
     _datagram_adapter.config_mut() = c_ad;
     _datagram_adapter.set_listening(true);
@@ -259,6 +383,10 @@ void TCPSpongeSocket<AdaptT>::_tcp_main() {
         }
         _tcp_loop([] { return true; });
         shutdown(SHUT_RDWR);
+        if (_handoff_in) {
+            _pump_handoff_in();
+        }
+        _end_handoff();
         if (not _tcp.value().active()) {
             cerr << "DEBUG: TCP connection finished "
                  << (_tcp.value().state() == TCPState::State::RESET ? "uncleanly" : "cleanly.\n");
@@ -266,6 +394,7 @@ void TCPSpongeSocket<AdaptT>::_tcp_main() {
         _tcp.reset();
     } catch (const exception &e) {
         cerr << "Exception in TCPConnection runner thread: " << e.what() << "\n";
+        _end_handoff();
         throw e;
     }
 }
@@ -6,12 +6,14 @@
 #include "fd_adapter.hh"
 #include "file_descriptor.hh"
 #include "network_interface.hh"
+#include "spsc_byte_stream.hh"
 #include "tcp_config.hh"
 #include "tcp_connection.hh"
 #include "tuntap_adapter.hh"
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <vector>
@@ -23,13 +25,25 @@ class TCPSpongeSocket : public LocalStreamSocket {
     //! Stream socket for reads and writes between owner and TCP thread
     LocalStreamSocket _thread_data;
 
+    //! \name In-process streams that replace `_thread_data` after use_stream_handoff()
+    //!@{
+    std::unique_ptr<SPSCByteStream> _handoff_out{};  //!< Bytes the owner writes for the TCP thread to send
+    std::unique_ptr<SPSCByteStream> _handoff_in{};   //!< Bytes the TCP thread received for the owner to read
+    //!@}
+
+    //! Move reassembled inbound bytes into `_handoff_in`, as far as it has room
+    void _pump_handoff_in();
+
+    //! Tell the owner, through the handoff streams, that the TCP thread is done with the connection
+    void _end_handoff();
+
   protected:
     //! Adapter to underlying datagram socket (e.g., UDP or IP)
     AdaptT _datagram_adapter;
 
   private:
-    //! Set up the TCPConnection and the event loop
-    void _initialize_TCP(const TCPConfig &config);
+    //! Set up the TCPConnection and the event loop, with the MSS clamped to fit the adapter's MTU
+    void _initialize_TCP(const TCPConfig &config, const FdAdapterConfig &adapter_config);
 
     //! TCP state machine
     std::optional<TCPConnection> _tcp{};
@@ -66,10 +80,30 @@ class TCPSpongeSocket : public LocalStreamSocket {
     //! or else may wait foreever for remote peer to close the TCP connection.
     void wait_until_closed();
 
+    //! \brief Exchange data with the TCP thread through lock-free in-process streams instead of the socket pair
+    //! \note Must be called before connect() or listen_and_accept(). Afterwards the owner reads and writes
+    //! through handoff_inbound() and handoff_outbound() rather than through this socket.
+    void use_stream_handoff(const size_t capacity = TCPConfig::DEFAULT_CAPACITY);
+
+    //! \name Owner's ends of the handoff streams (only valid after use_stream_handoff())
+    //!@{
+
+    //! The owner writes outbound bytes here, and calls end_input() to shut down the outbound direction
+    //! \note Once the TCP thread is done with the connection (closed, reset, or failed) this stream's
+    //! error() is set, and no more bytes will be taken; a writer should check it before waiting for space.
+    SPSCByteStream &handoff_outbound();
+
+    //! The owner reads inbound bytes here
+    //! \note The input ends after the peer closes cleanly; after a reset or failure, error() is set instead.
+    SPSCByteStream &handoff_inbound();
+    //!@}
+
     //! Connect using the specified configurations; blocks until connect succeeds or fails
+    //! \note The MSS is clamped so that a full segment fits `c_ad.mtu` (see TCPConfig::mss_for_mtu).
     void connect(const TCPConfig &c_tcp, const FdAdapterConfig &c_ad);
 
     //! Listen and accept using the specified configurations; blocks until accept succeeds or fails
+    //! \note The MSS is clamped as in connect().
     void listen_and_accept(const TCPConfig &c_tcp, const FdAdapterConfig &c_ad);
 
     //! When a connected socket is destructed, it will send a RST
@@ -122,6 +156,11 @@ using LossyTCPOverIPv4SpongeSocket = TCPSpongeSocket<LossyTCPOverIPv4OverTunFdAd
 //!   and [accept(2)](\ref man2::accept)
 //! - if TCPSpongeSocket is destructed while a TCP connection is open, the connection is
 //!   immediately terminated with a RST (call `wait_until_closed` to avoid this)
+//!
+//! By default the two threads exchange stream data through a pair of connected AF_UNIX sockets, so
+//! every byte is copied into and back out of the kernel. After use_stream_handoff(), they instead share
+//! two SPSCByteStream rings and wake each other through their EventFD events; the owner can poll
+//! handoff_inbound().data_event() and handoff_outbound().space_event() in its own EventLoop.
 
 //! Helper class that makes a TCPOverIPv4SpongeSocket behave more like a (kernel) TCPSocket
 class CS144TCPSocket : public TCPOverIPv4SpongeSocket {
@@ -2,17 +2,83 @@
 
 using namespace std;
 
+bool TCPReceiver::old_duplicate(const TCPSegment &seg) const noexcept {
+    const auto &ts = seg.header().options.timestamps;
+    if (!_timestamps || !_ts_recent || !ts || seg.header().rst)
+        return false;
+    return static_cast<int32_t>(ts->val - *_ts_recent) < 0;
+}
+
+//! \details With timestamps in use, a segment's TSval becomes the one to echo if the segment
+//! starts at or before the ackno last sent (RFC 7323 section 4.3), so a delayed ack echoes the
+//! earliest segment it acknowledges, and out-of-order segments don't shorten the measured RTT.
 void TCPReceiver::segment_received(const TCPSegment &seg) {
     const auto &header = seg.header();
 
     if (!(header.syn ^ syn_rcvd()))
         return;
 
-    if (header.syn) {
+    if (_timestamps && header.options.timestamps && !old_duplicate(seg) &&
+        (header.syn || unwrap(header.seqno, _isn.value(), ackno_absolute()) <= _last_ack_sent))
+        _ts_recent = header.options.timestamps->val;
+
+    if (header.syn)
         _isn = header.seqno;
-        _reassembler.push_substring(seg.payload().copy(), 0, header.fin);
-    } else { /* syn_rcvd() */
-        _reassembler.push_substring(
-            seg.payload().copy(), unwrap(header.seqno, _isn.value(), ackno_absolute()) - 1, header.fin);
+    const uint64_t index = header.syn ? 0 : unwrap(header.seqno, _isn.value(), ackno_absolute()) - 1;
+
+    const uint64_t window_end = stream_out().bytes_written() + window_size();
+    if (index + seg.payload().size() > window_end) {
+        const size_t fits = window_end > index ? window_end - index : 0;
+        _reassembler.push_substring(seg.payload().substr(0, fits), index, false);
+    } else {
+        _reassembler.push_substring(seg.payload(), index, header.fin);
     }
 }
+
+size_t TCPReceiver::window_size() const noexcept {
+    const ByteStream &stream = stream_out();
+    const uint64_t right_edge = max(stream.bytes_read() + _capacity, _right_edge);
+    if (right_edge <= stream.bytes_written())
+        return 0;
+    return min(right_edge - stream.bytes_written(), stream.remaining_capacity());
+}
+
+//! \details Once per RTT, the window is sized to twice what the application read in the last
+//! one, so a sender held back by the window can double its rate each round trip, while a slow
+//! reader isn't offered more than it drains. It grows at once but shrinks by at most a quarter
+//! per RTT, so a pause in reading doesn't forget the rate. Shrinking the capacity never pulls
+//! in the right edge already advertised (RFC 9293 section 3.8.6): that edge is kept instead.
+//! The buffers grow as the capacity rises, and are not shrunk again.
+void TCPReceiver::tune_window(const size_t ms_since_last_tick, const uint64_t rtt) {
+    if (_capacity_min == _capacity_max || !syn_rcvd() || !rtt)
+        return;
+
+    _tune_elapsed += ms_since_last_tick;
+    if (_tune_elapsed < rtt)
+        return;
+
+    const uint64_t read = stream_out().bytes_read();
+    const uint64_t read_per_rtt = (read - _tune_read) * rtt / _tune_elapsed;
+    _tune_read = read;
+    _tune_elapsed = 0;
+
+    const size_t target = clamp(static_cast<size_t>(2 * read_per_rtt), _capacity_min, _capacity_max);
+    if (target >= _capacity) {
+        _capacity = target;
+        _reassembler.grow(_capacity);
+    } else {
+        _right_edge = max(_right_edge, read + _capacity);
+        _capacity = max(target, _capacity - _capacity / 4);
+    }
+}
+
+vector<pair<WrappingInt32, WrappingInt32>> TCPReceiver::held_ranges() const {
+    vector<pair<WrappingInt32, WrappingInt32>> ranges;
+    if (!syn_rcvd())
+        return ranges;
+
+    // stream index `i` is absolute sequence number `i + 1` (the SYN comes first)
+    for (const auto &[first, last] : _reassembler.held_ranges())
+        ranges.emplace_back(wrap(first + 1, _isn.value()), wrap(last + 1, _isn.value()));
+    return ranges;
+}
@@ -6,7 +6,10 @@
 #include "tcp_segment.hh"
 #include "wrapping_integers.hh"
 
+#include <algorithm>
 #include <optional>
+#include <utility>
+#include <vector>
 
 //! \brief The "receiver" part of a TCP implementation.
 
@@ -20,6 +23,25 @@ class TCPReceiver {
     //! The isn
     std::optional<WrappingInt32> _isn{};
 
+    //! Whether segments carry timestamps (RFC 7323), the TSval to echo back, and the ackno
+    //! last sent to the peer (Last.ACK.sent), which decides whose TSval that is
+    bool _timestamps{false};
+    std::optional<uint32_t> _ts_recent{};
+    uint64_t _last_ack_sent{0};
+
+    //! The capacity the window offers now, and the bounds it is auto-tuned between (the upper
+    //! one is the stream's capacity; they are equal when the window isn't auto-tuned)
+    size_t _capacity;
+    size_t _capacity_min;
+    size_t _capacity_max;
+
+    //! The right edge of the window, in stream bytes, as of the last time the capacity shrank
+    uint64_t _right_edge{0};
+
+    //! The auto-tuning measurement under way: milliseconds since it began, and bytes read by then
+    uint64_t _tune_elapsed{0};
+    uint64_t _tune_read{0};
+
   public:
     bool syn_rcvd() const noexcept { return _isn.has_value(); }
     bool fin_rcvd() const noexcept { return stream_out().input_ended(); }
@@ -31,7 +53,18 @@ class TCPReceiver {
     //!
     //! \param capacity the maximum number of bytes that the receiver will
     //!                 store in its buffers at any give time.
-    TCPReceiver(const size_t capacity) : _reassembler(capacity) {}
+    //! \param reassembly how out-of-order bytes are held (see StreamReassembler::Storage)
+    //! \param max_fragments caps the out-of-order fragments held at once (0 means no limit)
+    //! \param capacity_max if greater than `capacity`, the window is auto-tuned between the two
+    //!                     (see tune_window); the buffers start at `capacity` and grow with the window
+    TCPReceiver(const size_t capacity,
+                const StreamReassembler::Storage reassembly = StreamReassembler::Storage::Map,
+                const size_t max_fragments = 0,
+                const size_t capacity_max = 0)
+        : _reassembler(capacity, reassembly, max_fragments)
+        , _capacity(capacity)
+        , _capacity_min(capacity)
+        , _capacity_max(std::max(capacity, capacity_max)) {}
 
     //! \name Accessors to provide feedback to the remote TCPSender
     //!@{
@@ -55,13 +88,46 @@ class TCPReceiver {
     //! the first byte that falls after the window (and will not be
     //! accepted by the receiver) and (b) the sequence number of the
     //! beginning of the window (the ackno).
-    size_t window_size() const noexcept { return stream_out().remaining_capacity(); }
+    //!
+    //! With auto-tuning, the capacity is the tuned one, but the window never ends before
+    //! a right edge already advertised.
+    size_t window_size() const noexcept;
+
+    //! \brief The most bytes the window can offer, which fixes the window scale to advertise
+    size_t capacity_max() const noexcept { return _capacity_max; }
     //!@}
 
+    //! \brief Let the window follow how fast the application reads, if it is auto-tuned
+    //! \param ms_since_last_tick the number of milliseconds since the last call
+    //! \param rtt the smoothed round-trip time, in milliseconds (0 if none has been measured)
+    void tune_window(const size_t ms_since_last_tick, const uint64_t rtt);
+
     //! \brief number of bytes stored but not yet reassembled
     size_t unassembled_bytes() const noexcept { return _reassembler.unassembled_bytes(); }
 
+    //! \brief The out-of-order sequence number ranges received beyond the ackno
+    //! \returns [left edge, right edge) pairs in increasing order, as a SACK block would report them
+    std::vector<std::pair<WrappingInt32, WrappingInt32>> held_ranges() const;
+
+    //! \brief The peer's TSval that segments sent now should echo as TSecr
+    //! \returns empty if timestamps aren't in use or no TSval has been recorded yet
+    std::optional<uint32_t> ts_recent() const noexcept { return _ts_recent; }
+
+    //! \brief Note that a segment carrying the current ackno has been sent to the peer
+    void ack_sent() noexcept { _last_ack_sent = ackno_absolute(); }
+
+    //! \brief Record and check the peer's timestamps (RFC 7323), once both sides have agreed to use them
+    void enable_timestamps() noexcept { _timestamps = true; }
+
+    //! \brief Whether `seg` is an old duplicate, by a TSval older than the last one recorded
+    //! \details Protection Against Wrapped Sequences (RFC 7323): with windows in the megabytes
+    //! a sequence number can come round again while an old segment carrying it is still in the
+    //! network. Such a segment should be dropped and only acknowledged.
+    bool old_duplicate(const TCPSegment &seg) const noexcept;
+
     //! \brief handle an inbound segment
+    //! \details Bytes beyond the window are dropped, even where the buffers still have room
+    //! for them (they keep the size of the largest window offered).
     void segment_received(const TCPSegment &seg);
 
     //! \name "Output" interface for the reader
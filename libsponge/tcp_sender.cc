@@ -2,6 +2,7 @@
 
 #include "tcp_config.hh"
 
+#include <cmath>
 #include <random>
 
 using namespace std;
@@ -13,25 +14,63 @@ TCPSender::TCPSender(const size_t capacity, const uint16_t retx_timeout, const s
     : _isn(fixed_isn.value_or(WrappingInt32{random_device()()}))
     , _initial_retransmission_timeout{retx_timeout}
     , _stream(capacity)
-    , _timer{retx_timeout} {}
+    , _timer{retx_timeout}
+    , _rtt{retx_timeout, TCPConfig::RTO_MIN_DFLT, TCPConfig::RTO_MAX_DFLT}
+    , _ts_offset(random_device()()) {}
 
+//! \param[in] config supplies the stream capacity, timeouts, ISN, MSS and congestion control algorithm
+TCPSender::TCPSender(const TCPConfig &config) : TCPSender(config.send_capacity, config.rt_timeout, config.fixed_isn) {
+    _mss = config.mss;
+    _gso_segments = max<size_t>(config.gso_segments, 1);
+    _cc_algorithm = config.congestion_control;
+    _cc = CongestionControl::make(_cc_algorithm, _mss);
+    _fast_retransmit = config.fast_retransmit;
+    _rack_tlp = config.rack_tlp;
+    _nagle = config.nagle;
+    _pacing = config.pacing;
+    _pacing_rate_max = config.pacing_rate_max;
+    _rtt = RTTEstimator{config.rt_timeout, config.rto_min, config.rto_max};
+    _adaptive_rto = config.adaptive_rto;
+}
+
+//! \details Sends while there is room in both the receiver's window (treated as one byte
+//! when it is zero, so the sender keeps probing) and the congestion window. Segments
+//! smaller than the MSS may be held back to coalesce small writes (see hold_small_segment()).
+//! With segmentation offload, a segment after the SYN carries up to `_gso_segments` MSS of
+//! payload, so this and the connection's flush run once per super-segment. With pacing, each
+//! segment spends the pacer's credit, and sending stops when that runs out (see tick()).
 void TCPSender::fill_window() {
-    uint16_t recv_win = _recv_win ? _recv_win : 1;
+    const uint64_t cwnd_now = _cc ? _cc->cwnd() + _recovery_inflation : cwnd();
+    const uint64_t window = min<uint64_t>(_recv_win ? _recv_win : 1, max<uint64_t>(cwnd_now, 1));
+    const bool paced = _pacing && syn_sent() && pacing_rate();
 
-    while (_next_seqno < _recv_ackno + recv_win) {
+    _pacing_held = false;
+    while (_next_seqno < _recv_ackno + window) {
         TCPSegment seg;
         size_t seg_size = 0;
-        size_t left_win = _recv_ackno + recv_win - _next_seqno;
+        size_t left_win = _recv_ackno + window - _next_seqno;
 
         if (!syn_sent()) {
             seg.header().syn = true;
             seg_size++;
         }
 
+        if (!seg.header().syn && hold_small_segment(left_win))
+            break;
+
+        if (paced && _pacing_credit <= 0) {
+            _pacing_held = stream_in().buffer_size() || (stream_in().eof() && !fin_sent());
+            break;
+        }
+
         if (size_t remain = left_win - seg_size; remain > 0) {
-            size_t readn = min(TCPConfig::MAX_PAYLOAD_SIZE, remain);
-            seg.payload() = stream_in().read(readn);
+            size_t readn = min(seg.header().syn ? _mss : _mss * _gso_segments, remain);
+            if (paced)
+                readn = min<size_t>(readn, max<int64_t>(_mss, _pacing_credit));
+            seg.payload() = stream_in().read_buffer(readn);
             seg_size += seg.payload().size();
+            if (seg.payload().size() > _mss)
+                seg.gso_size() = _mss;
         }
 
         if (seg_size < left_win && !fin_sent() && stream_in().eof()) {
@@ -43,58 +82,324 @@ void TCPSender::fill_window() {
             break;
 
         seg.header().seqno = wrap(_next_seqno, _isn);
+        _write_queue.push(_next_seqno, seg, _time);
         _next_seqno += seg_size;
-        segments_out().push(seg);
-        _write_queue.push_back(move(seg));
+        if (!_timing) {
+            _timing = true;
+            _timed_seqno = _next_seqno;
+            _timed_at = _time;
+        }
+        segments_out().push(move(seg));
         if (_timer.stopped())
             _timer.start();
+        if (paced)
+            _pacing_credit -= seg_size;
+        if (_rack_tlp)
+            arm_tlp();
     }
 }
 
+uint64_t TCPSender::pacing_rate() const {
+    if (!_pacing)
+        return 0;
+    if (!_rtt.has_sample())
+        return _pacing_rate_max;
+
+    const uint64_t window = min<uint64_t>(cwnd(), max<uint64_t>(_recv_win, _mss));
+    const bool slow_start = _cc && _cc->cwnd() < _cc->ssthresh();
+    const double rate = window * 1000.0 / max(_rtt.srtt(), 1.0) * (slow_start ? 2 : 1.25);
+    const uint64_t whole = rate < double(UINT64_MAX) ? static_cast<uint64_t>(rate) : UINT64_MAX;
+    return _pacing_rate_max ? min(whole, _pacing_rate_max) : whole;
+}
+
+uint64_t TCPSender::pacing_delay() const {
+    const uint64_t rate = pacing_rate();
+    if (!_pacing_held || !rate)
+        return 0;
+    const auto owed = static_cast<uint64_t>(1 - _pacing_credit);  // bytes of credit until the next segment may go
+    return max<uint64_t>((owed * 1000 + rate - 1) / rate, 1);
+}
+
+//! \details A segment is held when it would carry less than an MSS and, with Nagle's
+//! algorithm, data is still unacknowledged, or the sender is corked. The segment that
+//! carries the end of the stream is never held, so closing flushes everything.
+bool TCPSender::hold_small_segment(const size_t room) const {
+    if (!_corked && !(_nagle && bytes_in_flight()))
+        return false;
+    return !stream_in().input_ended() && min(room, stream_in().buffer_size()) < _mss;
+}
+
 //! \param ackno The remote receiver's ackno (acknowledgment number)
-//! \param window_size The remote receiver's advertised window size
-void TCPSender::ack_received(const WrappingInt32 ackno, const uint16_t window_size) {
+//! \param window_size The remote receiver's advertised window size, in bytes (after any window scaling)
+//! \param pure Whether the segment carrying the ack occupied no sequence numbers
+//! \param tsecr The TSecr of the segment carrying the ack, if timestamps are in use
+//! \details With timestamps, every ack of new data gives an RTT sample, even one for a
+//! retransmission, as the echo tells which transmission it answers (RFC 7323).
+//! Otherwise one segment per round trip is timed.
+void TCPSender::ack_received(const WrappingInt32 ackno,
+                             const uint64_t window_size,
+                             const bool pure,
+                             const optional<uint32_t> tsecr) {
     uint64_t ackno_abs = unwrap(ackno, _isn, next_seqno_absolute());
 
     if (ackno_abs < _recv_ackno || next_seqno_absolute() < ackno_abs)
         return;
 
+    if (ackno_abs == _recv_ackno) {
+        if (_fast_retransmit && pure && bytes_in_flight() && window_size == _recv_win)
+            duplicate_ack();
+        _recv_win = window_size;
+        return;
+    }
+    _dup_acks = 0;
+
+    // the congestion window counts data, so the ack of the SYN doesn't grow it,
+    // and neither do acks during fast recovery
+    if (_cc && syn_acked() && !_in_recovery)
+        _cc->on_ack(ackno_abs - _recv_ackno, _time);
+
+    const uint64_t acked = ackno_abs - _recv_ackno;
+
+    if (_rack_tlp)
+        rack_update(ackno_abs);
+
+    if (tsecr) {
+        // an echo from the future, or from before the connection began, is bogus
+        if (const uint32_t rtt = ts_val() - *tsecr; rtt <= _time)
+            _rtt.sample(rtt);
+        _timing = false;
+    } else if (_timing && ackno_abs >= _timed_seqno) {
+        // Karn's rule: `_timing` is cleared on retransmission, so this sample is unambiguous
+        _rtt.sample(_time - _timed_at);
+        _timing = false;
+    }
+
     _recv_ackno = ackno_abs;
     _recv_win = window_size;
 
-    bool write_out = false;
-    for (auto it = _write_queue.begin(); it != _write_queue.end();) {
-        uint64_t seqno_abs = unwrap(it->header().seqno, _isn, next_seqno_absolute());
-        if (seqno_abs + it->length_in_sequence_space() <= _recv_ackno) {
-            it = _write_queue.erase(it);
-            write_out = true;
-        } else {
-            break;
+    // any ack of new data restarts the timer and ends the backoff (RFC 6298 section 5.3),
+    // including one that covers only part of a super-segment
+    _write_queue.acknowledge(_recv_ackno);
+    _retrans_cnt = 0;
+    _timer.setup(current_rto());
+    if (!_write_queue.empty())
+        _timer.start();
+    else
+        _timer.reset();
+
+    if (_tlp_out && _recv_ackno >= _tlp_end)
+        _tlp_out = false;
+
+    if (_in_recovery) {
+        if (_recv_ackno >= _recover) {
+            // full acknowledgment: recovery is over, and the window is ssthresh
+            _in_recovery = false;
+            _recovery_inflation = 0;
+        } else if (!_write_queue.empty()) {
+            // partial acknowledgment: the next hole is lost too, so resend it right away
+            // and deflate the window by what was acknowledged (RFC 6582)
+            retransmit_front();
+            _recovery_inflation = (_recovery_inflation > acked ? _recovery_inflation - acked : 0) + _mss;
         }
     }
 
-    if (write_out) {
-        _retrans_cnt = 0;
-        _timer.setup(_initial_retransmission_timeout);
-        if (!_write_queue.empty())
-            _timer.start();
-        else
-            _timer.reset();
+    if (_rack_tlp) {
+        rack_detect_loss();
+        arm_tlp();
+    }
+}
+
+//! \details Peers asking for less than TCPConfig::MIN_MSS get that much anyway. The congestion
+//! window is counted in segments at first, so the controller is made again for the new size.
+void TCPSender::limit_mss(const size_t mss) {
+    const size_t limited = max(min(_mss, mss), TCPConfig::MIN_MSS);
+    if (limited == _mss)
+        return;
+    _mss = limited;
+    _cc = CongestionControl::make(_cc_algorithm, _mss);
+}
+
+//! \details Only the piece of a super-segment that starts at the ackno (or at the segment, if
+//! it lies beyond the ackno) is resent, as the receiver may hold the rest of it already.
+void TCPSender::retransmit(RetransmissionQueue::Entry &entry) {
+    entry.sent_at = _time;
+    entry.retransmitted = true;
+    if (entry.segment.is_super_segment()) {
+        const uint64_t acked = _recv_ackno > entry.seqno ? _recv_ackno - entry.seqno : 0;
+        const size_t pos = acked - (acked && entry.segment.header().syn ? 1 : 0);
+        segments_out().push(entry.segment.piece(pos, _mss));
+    } else {
+        segments_out().push(entry.segment);
+    }
+}
+
+void TCPSender::retransmit_front() {
+    retransmit(_write_queue.front());
+    _timing = false;
+}
+
+//! \details The third duplicate in a row starts fast retransmit: the oldest outstanding
+//! segment is resent at once and the congestion controller is told of the loss. Until
+//! everything outstanding at that point is acknowledged, each further duplicate (a
+//! segment that left the network) lets one more segment out.
+void TCPSender::duplicate_ack() {
+    ++_dup_acks;
+    if (_in_recovery) {
+        _recovery_inflation += _mss;
+        return;
     }
+    if (_dup_acks < TCPConfig::DUP_ACK_THRESHOLD || _recv_ackno < _recover)
+        return;
+
+    retransmit_front();
+    enter_recovery();
+    if (_cc)
+        _recovery_inflation = TCPConfig::DUP_ACK_THRESHOLD * _mss;
+}
+
+void TCPSender::enter_recovery() {
+    _in_recovery = true;
+    _recover = _next_seqno;
+    if (_cc)
+        _cc->on_loss(bytes_in_flight(), _time);
+}
+
+//! \details Of the segments `ackno` acknowledges, the one sent last tells how recently sent
+//! data is known to have arrived. A retransmission acknowledged within the minimum RTT of
+//! being resent was most likely acknowledged for its first transmission, so it is left out
+//! (RFC 8985 section 6.2).
+void TCPSender::rack_update(const uint64_t ackno) {
+    for (size_t i = 0; i < _write_queue.size() && _write_queue[i].end <= ackno; ++i) {
+        const auto &entry = _write_queue[i];
+        const uint64_t rtt = _time - entry.sent_at;
+        if (entry.retransmitted && _rtt.has_sample() && rtt < _rtt.min_rtt())
+            continue;
+        if (!_rack_valid || entry.sent_at >= _rack_xmit_ts) {
+            _rack_valid = true;
+            _rack_xmit_ts = entry.sent_at;
+            _rack_rtt = rtt;
+        }
+    }
+}
+
+//! \details An outstanding segment sent before the most recently delivered one is lost once
+//! RACK.rtt plus a reordering window (a quarter of the minimum RTT) has passed since it was
+//! sent; until then, the reordering timer is set for that moment. Acks here are cumulative
+//! only, so this catches segments left behind when a retransmission is acknowledged, and
+//! the losses are resent together rather than one per round trip. Of a lost super-segment
+//! only the first MSS goes again; partial acks during the recovery this starts resend the rest.
+void TCPSender::rack_detect_loss() {
+    _reorder_deadline = 0;
+    if (!_rack_valid)
+        return;
+
+    const uint64_t reordering_window = _rtt.has_sample() ? _rtt.min_rtt() / 4 : 0;
+    bool lost = false;
+    for (size_t i = 0; i < _write_queue.size(); ++i) {
+        auto &entry = _write_queue[i];
+        if (entry.sent_at >= _rack_xmit_ts) {
+            // a segment sent once, after the delivered one, means everything later was too
+            if (!entry.retransmitted)
+                break;
+            continue;
+        }
+        const uint64_t deadline = entry.sent_at + _rack_rtt + reordering_window;
+        if (deadline <= _time) {
+            retransmit(entry);
+            lost = true;
+        } else if (!_reorder_deadline || deadline < _reorder_deadline) {
+            _reorder_deadline = deadline;
+        }
+    }
+
+    if (lost) {
+        _timing = false;
+        if (!_in_recovery)
+            enter_recovery();
+    }
+}
+
+//! \details The probe timeout is twice the smoothed RTT, plus the time the receiver may hold a
+//! delayed ACK back when only one segment is in flight. There is no probe during recovery,
+//! before an RTT is measured, or while one is outstanding.
+void TCPSender::arm_tlp() {
+    _tlp_deadline = 0;
+    if (_tlp_out || _in_recovery || _write_queue.empty() || !_rtt.has_sample() || !_recv_win)
+        return;
+
+    uint64_t pto = max<uint64_t>(2 * static_cast<uint64_t>(ceil(_rtt.srtt())), 1);
+    if (bytes_in_flight() <= _mss)
+        pto += TCPConfig::MAX_ACK_DELAY;
+    if (!_timer.stopped() && pto >= _timer.remaining())
+        return;
+    _tlp_deadline = _time + pto;
+}
+
+//! \details New data makes the better probe, as it also moves the transfer along; failing
+//! that, the last segment (or its last MSS) is resent, so the ack tells whether the tail
+//! arrived. The retransmission timer then restarts from the probe.
+void TCPSender::send_probe() {
+    _tlp_deadline = 0;
+    if (_write_queue.empty())
+        return;
+
+    _tlp_out = true;
+    const uint64_t before = _next_seqno;
+    fill_window();
+    if (_next_seqno == before) {
+        auto &last = _write_queue.back();
+        if (last.segment.is_super_segment()) {
+            const size_t size = last.segment.payload().size();
+            segments_out().push(last.segment.piece((size - 1) / _mss * _mss, _mss));
+        } else {
+            segments_out().push(last.segment);
+        }
+        last.sent_at = _time;
+        last.retransmitted = true;
+        _timing = false;
+    }
+    _tlp_end = _next_seqno;
+    _timer.start();
 }
 
 //! \param[in] ms_since_last_tick the number of milliseconds since the last call to this method
 void TCPSender::tick(const size_t ms_since_last_tick) {
+    _time += ms_since_last_tick;
+
     if (_timer.tick(ms_since_last_tick)) {
-        segments_out().push(_write_queue.front());
+        retransmit_front();
 
+        // duplicates of acks for data sent before the timeout mustn't start fast recovery (RFC 6582 section 3.2)
+        _tlp_out = false;
+        _tlp_deadline = _reorder_deadline = 0;
+        _in_recovery = false;
+        _recover = _next_seqno;
+        _recovery_inflation = 0;
+        _dup_acks = 0;
         if (_recv_win) {
             _retrans_cnt++;
-            _timer.setup(2 * _timer.time());
+            _timer.setup(_adaptive_rto ? min<uint64_t>(2 * _timer.time(), _rtt.rto_max()) : 2 * _timer.time());
+            if (_cc)
+                _cc->on_timeout(bytes_in_flight(), _time);
         }
 
         _timer.start();
     }
+
+    if (_reorder_deadline && _time >= _reorder_deadline)
+        rack_detect_loss();
+    if (_tlp_deadline && _time >= _tlp_deadline)
+        send_probe();
+
+    if (const uint64_t rate = pacing_rate(); rate) {
+        const auto burst = static_cast<int64_t>(pacing_burst(rate));
+        const uint64_t millibytes = rate * ms_since_last_tick + _pacing_millibytes;
+        const auto earned = static_cast<int64_t>(min<uint64_t>(millibytes / 1000, burst));
+        _pacing_credit = min(_pacing_credit + earned, burst);
+        _pacing_millibytes = _pacing_credit < burst ? millibytes % 1000 : 0;
+        if (_pacing_held)
+            fill_window();
+    }
 }
 
 void TCPSender::send_empty_segment() {
@@ -2,12 +2,16 @@
 #define SPONGE_LIBSPONGE_TCP_SENDER_HH
 
 #include "byte_stream.hh"
+#include "congestion_control.hh"
+#include "retransmission_queue.hh"
+#include "rtt_estimator.hh"
 #include "tcp_config.hh"
 #include "tcp_segment.hh"
 #include "wrapping_integers.hh"
 
+#include <algorithm>
 #include <functional>
-#include <list>
+#include <memory>
 #include <queue>
 
 //! \brief The "sender" part of a TCP implementation.
@@ -53,11 +57,12 @@ class TCPSender {
             return false;
         }
         unsigned int time() const noexcept { return _time; }
+        unsigned int remaining() const noexcept { return _countdown > 0 ? _countdown : 0; }
         bool stopped() const noexcept { return _countdown <= 0; }
     };
 
-    //!
-    std::list<TCPSegment> _write_queue{};
+    //! segments sent but not yet acknowledged
+    RetransmissionQueue _write_queue{};
 
     //!
     CountDownTimer _timer;
@@ -65,11 +70,122 @@ class TCPSender {
     //! receiver want to get
     uint64_t _recv_ackno{};
 
-    //! receiver window
-    uint16_t _recv_win{1};
+    //! receiver window, in bytes (already scaled)
+    uint64_t _recv_win{1};
 
     unsigned int _retrans_cnt{0};
 
+    //! congestion controller (null when only the receiver's window limits sending)
+    CongestionControl::Algorithm _cc_algorithm{CongestionControl::Algorithm::None};
+    std::unique_ptr<CongestionControl> _cc{};
+
+    //! milliseconds elapsed, as reported by tick()
+    uint64_t _time{0};
+
+    //! round-trip time estimate, from one timed segment per round trip
+    RTTEstimator _rtt;
+
+    //! whether the retransmission timeout follows `_rtt` (otherwise it starts at the initial value)
+    bool _adaptive_rto{false};
+
+    //! random offset of the timestamp clock (RFC 7323), so TSvals don't reveal the sender's uptime
+    uint32_t _ts_offset;
+
+    //! whether a segment is being timed; its ack must cover `_timed_seqno` (absolute)
+    bool _timing{false};
+    uint64_t _timed_seqno{0};
+    uint64_t _timed_at{0};
+
+    //! payload bytes per segment
+    size_t _mss{TCPConfig::MAX_PAYLOAD_SIZE};
+
+    //! most MSS-sized pieces in one super-segment (see TCPSegment::gso_size())
+    size_t _gso_segments{1};
+
+    //! whether duplicate acks trigger fast retransmit and recovery
+    bool _fast_retransmit{false};
+
+    //! whether segments smaller than the MSS wait until nothing is in flight (Nagle's algorithm)
+    bool _nagle{false};
+
+    //! whether segments smaller than the MSS wait until uncorked
+    bool _corked{false};
+
+    //! whether fill_window() is paced, and the cap on the rate (bytes per second, 0 for none)
+    bool _pacing{false};
+    uint64_t _pacing_rate_max{0};
+
+    //! bytes the pacer lets out now; it may go negative by part of a segment, which is paid back first
+    int64_t _pacing_credit{0};
+
+    //! credit earned but not yet a whole byte, in thousandths of a byte, so slow rates and short ticks add up
+    uint64_t _pacing_millibytes{0};
+
+    //! whether the pacer stopped fill_window() with sendable data left
+    bool _pacing_held{false};
+
+    //! most credit the pacer saves up, so idle time doesn't turn into a burst
+    uint64_t pacing_burst(const uint64_t rate) const noexcept { return std::max<uint64_t>(2 * _mss, rate / 1000); }
+
+    //! whether the next segment would be smaller than the MSS and should wait; `room` is how many
+    //! payload bytes the window allows
+    bool hold_small_segment(const size_t room) const;
+
+    //! duplicate acks received in a row
+    unsigned int _dup_acks{0};
+
+    //! whether fast recovery is in progress, until everything below `_recover` (absolute) is acked
+    bool _in_recovery{false};
+    uint64_t _recover{0};
+
+    //! bytes the congestion window is temporarily inflated by during fast recovery
+    uint64_t _recovery_inflation{0};
+
+    //! resend an outstanding segment (just its first unacknowledged MSS, if it is a super-segment)
+    void retransmit(RetransmissionQueue::Entry &entry);
+
+    //! resend the oldest outstanding segment, as retransmit does, and stop timing it
+    void retransmit_front();
+
+    //! whether losses are detected with RACK and tail loss probes (RFC 8985)
+    bool _rack_tlp{false};
+
+    //! send time and RTT of the most recently sent segment known to be delivered (RACK.xmit_ts, RACK.rtt)
+    bool _rack_valid{false};
+    uint64_t _rack_xmit_ts{0};
+    uint64_t _rack_rtt{0};
+
+    //! when the RACK reordering timer and the probe timeout fire (0: not armed)
+    uint64_t _reorder_deadline{0};
+    uint64_t _tlp_deadline{0};
+
+    //! whether a probe is outstanding, until everything below `_tlp_end` (absolute) is acked
+    bool _tlp_out{false};
+    uint64_t _tlp_end{0};
+
+    //! take note of the segments an ack of `ackno` (absolute) delivers
+    void rack_update(const uint64_t ackno);
+
+    //! resend segments sent well before the most recently delivered one
+    void rack_detect_loss();
+
+    //! schedule a tail loss probe for two smoothed RTTs from now, if the RTO doesn't come first
+    void arm_tlp();
+
+    //! send new data or resend the last segment, to draw an ack out of the receiver
+    void send_probe();
+
+    //! enter fast recovery, with the congestion controller told of the loss
+    void enter_recovery();
+
+    //! handle an ack that repeats the last ackno and window while data is outstanding
+    void duplicate_ack();
+
+    //! the retransmission timeout to start from after new data is acknowledged
+    unsigned int current_rto() const noexcept {
+        return _adaptive_rto ? _rtt.rto() : _initial_retransmission_timeout;
+    }
+
   public:
     uint64_t recv_ackno_absolute() const noexcept { return _recv_ackno; }
     uint64_t recv_win() const noexcept { return _recv_win; }
@@ -84,6 +200,9 @@ class TCPSender {
               const uint16_t retx_timeout = TCPConfig::TIMEOUT_DFLT,
               const std::optional<WrappingInt32> fixed_isn = {});
 
+    //! Initialize a TCPSender from the sending half of `config`, including its congestion control
+    explicit TCPSender(const TCPConfig &config);
+
     //! \name "Input" interface for the writer
     //!@{
     ByteStream &stream_in() noexcept { return _stream; }
@@ -94,7 +213,21 @@ class TCPSender {
     //!@{
 
     //! \brief A new acknowledgment was received
-    void ack_received(const WrappingInt32 ackno, const uint16_t window_size);
+    //! \param pure is false when the ack rode on a segment carrying data, SYN or FIN,
+    //! which never counts as a duplicate ack
+    //! \param tsecr is the timestamp the ack echoes, if timestamps are in use (see ts_val())
+    void ack_received(const WrappingInt32 ackno,
+                      const uint64_t window_size,
+                      const bool pure = true,
+                      const std::optional<uint32_t> tsecr = {});
+
+    //! \brief Send no larger payloads than `mss` (the peer's MSS, less the options every segment carries)
+    //! \note Call before any data is sent, as the congestion controller starts over
+    void limit_mss(const size_t mss);
+
+    //! \brief While corked, segments smaller than the MSS are held back (unless they end the stream)
+    //! \note Call fill_window() after uncorking to send what was held
+    void set_corked(const bool corked) noexcept { _corked = corked; }
 
     //! \brief Generate an empty-payload segment (useful for creating empty ACK segments)
     void send_empty_segment();
@@ -114,6 +247,31 @@ class TCPSender {
     //! (see TCPSegment::length_in_sequence_space())
     size_t bytes_in_flight() const noexcept { return _next_seqno - _recv_ackno; }
 
+    //! \brief The congestion window, or the largest possible window if there is no congestion control
+    uint64_t cwnd() const noexcept { return _cc ? _cc->cwnd() : UINT64_MAX; }
+
+    //! \brief The round-trip time estimate (SRTT, RTTVAR and the RTO they imply)
+    const RTTEstimator &rtt() const noexcept { return _rtt; }
+
+    //! \brief The timestamp clock, in milliseconds, for the TSval of segments sent now (RFC 7323)
+    uint32_t ts_val() const noexcept { return _ts_offset + static_cast<uint32_t>(_time); }
+
+    //! \brief Largest payload sent in one segment
+    size_t mss() const noexcept { return _mss; }
+
+    //! \brief The rate segments are paced at, in bytes per second (0 if they aren't paced)
+    //! \details The window over the smoothed RTT, doubled in slow start and raised by a quarter
+    //! after that so the window can still grow, and limited by TCPConfig::pacing_rate_max.
+    //! Until an RTT is measured, only the cap paces the sender.
+    uint64_t pacing_rate() const;
+
+    //! \brief Milliseconds until the pacer lets out data it is holding back (0 if it holds none)
+    //! \note Calling tick() then sends it
+    uint64_t pacing_delay() const;
+
+    //! \brief Whether fast recovery is in progress
+    bool in_fast_recovery() const noexcept { return _in_recovery; }
+
     //! \brief Number of consecutive retransmissions that have occurred in a row
     unsigned int consecutive_retransmissions() const noexcept { return _retrans_cnt; }
 
@@ -2,13 +2,48 @@
 
 using namespace std;
 
+//! \param[in] data is the bytes to copy
+Buffer Buffer::copy_from(const string_view data) {
+    if (data.empty()) {
+        return {};
+    }
+    return {BufferStorage::copy_of(data), 0, data.size()};
+}
+
+//! \param[in] data is the (possibly discontiguous) bytes to copy
+Buffer Buffer::gather(const BufferViewList &data) {
+    const size_t size = data.size();
+    if (size == 0) {
+        return {};
+    }
+    BufferStorage *storage = BufferStorage::create(size);
+    char *out = storage->mutable_data();
+    for (const auto &iov : data.as_iovecs()) {
+        out = copy_n(static_cast<const char *>(iov.iov_base), iov.iov_len, out);
+    }
+    return {storage, 0, size};
+}
+
+Buffer Buffer::substr(const size_t pos, const size_t n) const {
+    if (pos > _size) {
+        throw out_of_range("Buffer::substr");
+    }
+    const size_t len = min(n, _size - pos);
+    if (len == 0) {
+        return {};
+    }
+    _storage->retain();
+    return {_storage, _starting_offset + pos, len};
+}
+
 void Buffer::remove_prefix(const size_t n) {
-    if (n > str().size()) {
+    if (n > _size) {
         throw out_of_range("Buffer::remove_prefix");
     }
     _starting_offset += n;
-    if (_storage and _starting_offset == _storage->size()) {
-        _storage.reset();
+    _size -= n;
+    if (_size == 0) {
+        reset();
     }
 }
 
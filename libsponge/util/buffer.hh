@@ -1,9 +1,10 @@
 #ifndef SPONGE_LIBSPONGE_BUFFER_HH
 #define SPONGE_LIBSPONGE_BUFFER_HH
 
+#include "buffer_storage.hh"
+
 #include <algorithm>
 #include <deque>
-#include <memory>
 #include <numeric>
 #include <stdexcept>
 #include <string>
@@ -11,17 +12,81 @@
 #include <sys/uio.h>
 #include <vector>
 
+class BufferViewList;
+
 //! \brief A reference-counted read-only string that can discard bytes from the front
+//! \note Several Buffers can share one BufferStorage, each viewing a different slice of it.
+//! Copying a Buffer only bumps a non-atomic reference count (see BufferStorage).
 class Buffer {
   private:
-    std::shared_ptr<std::string> _storage{};
+    BufferStorage *_storage{};
     size_t _starting_offset{};
+    size_t _size{};
+
+    //! \brief Construct a slice of `size` bytes of `storage`, starting at `offset` (takes over one reference)
+    Buffer(BufferStorage *storage, const size_t offset, const size_t size) noexcept
+        : _storage(storage), _starting_offset(offset), _size(size) {}
+
+    //! \brief Drop this Buffer's reference to its storage
+    void reset() noexcept {
+        if (_storage) {
+            _storage->release();
+            _storage = nullptr;
+        }
+        _starting_offset = _size = 0;
+    }
 
   public:
     Buffer() = default;
 
     //! \brief Construct by taking ownership of a string
-    Buffer(std::string &&str) noexcept : _storage(std::make_shared<std::string>(std::move(str))) {}
+    //! \details Short strings, and ones mostly spare capacity, are copied (see BufferStorage::adopt)
+    Buffer(std::string &&str) : _storage(BufferStorage::adopt(std::move(str))), _size(_storage->bytes().size()) {}
+
+    //! \brief Construct by copying `data` into pooled storage
+    static Buffer copy_from(const std::string_view data);
+
+    //! \brief Construct by gathering the bytes of `data` into pooled storage
+    static Buffer gather(const BufferViewList &data);
+
+    //! \name Copy and move share the storage (no bytes are copied)
+    //!@{
+    Buffer(const Buffer &other) noexcept
+        : _storage(other._storage), _starting_offset(other._starting_offset), _size(other._size) {
+        if (_storage) {
+            _storage->retain();
+        }
+    }
+
+    Buffer(Buffer &&other) noexcept
+        : _storage(other._storage), _starting_offset(other._starting_offset), _size(other._size) {
+        other._storage = nullptr;
+        other._starting_offset = other._size = 0;
+    }
+
+    Buffer &operator=(const Buffer &other) noexcept {
+        if (other._storage) {
+            other._storage->retain();
+        }
+        reset();
+        _storage = other._storage;
+        _starting_offset = other._starting_offset;
+        _size = other._size;
+        return *this;
+    }
+
+    Buffer &operator=(Buffer &&other) noexcept {
+        if (this != &other) {
+            reset();
+            std::swap(_storage, other._storage);
+            std::swap(_starting_offset, other._starting_offset);
+            std::swap(_size, other._size);
+        }
+        return *this;
+    }
+
+    ~Buffer() { reset(); }
+    //!@}
 
     //! \name Expose contents as a std::string_view
     //!@{
@@ -29,7 +94,7 @@ class Buffer {
         if (not _storage) {
             return {};
         }
-        return {_storage->data() + _starting_offset, _storage->size() - _starting_offset};
+        return _storage->bytes().substr(_starting_offset, _size);
     }
 
     operator std::string_view() const { return str(); }
@@ -39,11 +104,14 @@ class Buffer {
     uint8_t at(const size_t n) const { return str().at(n); }
 
     //! \brief Size of the string
-    size_t size() const { return str().size(); }
+    size_t size() const { return _size; }
 
     //! \brief Make a copy to a new std::string
     std::string copy() const { return std::string(str()); }
 
+    //! \brief A Buffer sharing `n` bytes of this one's storage, starting at `pos` (does not require a copy)
+    Buffer substr(const size_t pos, const size_t n) const;
+
     //! \brief Discard the first `n` bytes of the string (does not require a copy or move)
     //! \note Doesn't free any memory until the whole string has been discarded in all copies of the Buffer.
     void remove_prefix(const size_t n);
@@ -102,6 +170,8 @@ class BufferViewList {
     //! \name Constructors
     //!@{
 
+    BufferViewList() = default;
+
     //! \brief Construct from a std::string
     BufferViewList(const std::string &str) : BufferViewList(std::string_view(str)) {}
 
@@ -115,6 +185,13 @@ class BufferViewList {
     BufferViewList(std::string_view str) { _views.push_back({const_cast<char *>(str.data()), str.size()}); }
     //!@}
 
+    //! \brief Append a view to the end of the string (empty views are ignored)
+    void append(std::string_view str) {
+        if (not str.empty()) {
+            _views.push_back(str);
+        }
+    }
+
     //! \brief Discard the first `n` bytes of the string (does not require a copy or move)
     void remove_prefix(size_t n);
 
@@ -0,0 +1,129 @@
+#include "buffer_storage.hh"
+
+#include <array>
+#include <new>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t NUM_CLASSES = 11;  // 64 B, 128 B, ..., 64 KiB
+static_assert(BufferPool::MIN_CLASS_SIZE << (NUM_CLASSES - 1) == BufferPool::MAX_CLASS_SIZE);
+
+//! A cached block, linked through its own first bytes
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+//! The calling thread's free lists. Trivially destructible, so it stays usable
+//! while other thread_local and static objects are destroyed at exit.
+struct FreeLists {
+    array<FreeBlock *, NUM_CLASSES> heads;
+    array<size_t, NUM_CLASSES> counts;
+    bool closed;  //!< Set once the thread is exiting; later frees bypass the lists
+};
+
+thread_local FreeLists free_lists{};
+
+//! Returns the cached blocks to the global allocator when its thread exits
+struct FreeListsCloser {
+    FreeListsCloser() = default;
+    FreeListsCloser(const FreeListsCloser &) = delete;
+    FreeListsCloser &operator=(const FreeListsCloser &) = delete;
+    ~FreeListsCloser() {
+        for (auto &head : free_lists.heads) {
+            while (head) {
+                FreeBlock *block = head;
+                head = block->next;
+                ::operator delete(block);
+            }
+        }
+        free_lists.closed = true;
+    }
+};
+
+thread_local FreeListsCloser free_lists_closer{};
+
+//! \returns the index of the smallest size class holding `size` bytes
+size_t size_class(const size_t size) {
+    size_t index = 0;
+    for (size_t class_size = BufferPool::MIN_CLASS_SIZE; class_size < size; class_size <<= 1) {
+        ++index;
+    }
+    return index;
+}
+
+}  // namespace
+
+//! \param[in] size is the number of bytes needed
+void *BufferPool::allocate(const size_t size) {
+    if (size > MAX_CLASS_SIZE) {
+        return ::operator new(size);
+    }
+
+    static_cast<void>(free_lists_closer);  // registers the closer for this thread
+    const size_t index = size_class(size);
+    if (FreeBlock *block = free_lists.heads[index]) {
+        free_lists.heads[index] = block->next;
+        --free_lists.counts[index];
+        return block;
+    }
+    return ::operator new(MIN_CLASS_SIZE << index);
+}
+
+//! \param[in] block was returned by allocate()
+//! \param[in] size is the size that was passed to allocate()
+void BufferPool::deallocate(void *block, const size_t size) noexcept {
+    if (size > MAX_CLASS_SIZE or free_lists.closed) {
+        ::operator delete(block);
+        return;
+    }
+
+    const size_t index = size_class(size);
+    if (free_lists.counts[index] >= max(size_t(8), MAX_CACHED_BYTES / (MIN_CLASS_SIZE << index))) {
+        ::operator delete(block);
+        return;
+    }
+    free_lists.heads[index] = new (block) FreeBlock{free_lists.heads[index]};
+    ++free_lists.counts[index];
+}
+
+BufferStorage::BufferStorage(const size_t block_size, string &&owned)
+    : _block_size(block_size), _owned(move(owned)), _data(_owned.data()), _size(_owned.size()) {}
+
+BufferStorage::BufferStorage(const size_t block_size, const size_t inline_size)
+    : _block_size(block_size), _owned(), _data(reinterpret_cast<char *>(this + 1)), _size(inline_size) {}
+
+//! \param[in] str is the string whose bytes the storage will hold
+BufferStorage *BufferStorage::adopt(string &&str) {
+    if (str.size() < ADOPT_MIN_SIZE || str.capacity() / 2 > str.size()) {
+        return copy_of(str);
+    }
+    void *block = BufferPool::allocate(sizeof(BufferStorage));
+    return new (block) BufferStorage(sizeof(BufferStorage), move(str));
+}
+
+//! \param[in] data is the bytes to copy
+BufferStorage *BufferStorage::copy_of(const string_view data) {
+    BufferStorage *storage = create(data.size());
+    data.copy(storage->mutable_data(), data.size());
+    return storage;
+}
+
+//! \param[in] size is the number of bytes the storage will hold
+BufferStorage *BufferStorage::create(const size_t size) {
+    const size_t block_size = sizeof(BufferStorage) + size;
+    void *block = BufferPool::allocate(block_size);
+    return new (block) BufferStorage(block_size, size);
+}
+
+void BufferStorage::release() noexcept {
+    if (--_refs) {
+        return;
+    }
+
+    const size_t block_size = _block_size;
+    this->~BufferStorage();
+    BufferPool::deallocate(this, block_size);
+}
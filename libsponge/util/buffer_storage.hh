@@ -0,0 +1,78 @@
+#ifndef SPONGE_LIBSPONGE_BUFFER_STORAGE_HH
+#define SPONGE_LIBSPONGE_BUFFER_STORAGE_HH
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+//! \brief Per-thread free lists of recycled allocations, one per power-of-two size class
+//! \details Requests larger than MAX_CLASS_SIZE go straight to the global allocator.
+//! A block may be freed on a different thread than the one that allocated it;
+//! it then joins that thread's free list.
+class BufferPool {
+  public:
+    static constexpr size_t MIN_CLASS_SIZE = 64;             //!< Smallest size class, in bytes
+    static constexpr size_t MAX_CLASS_SIZE = 64 * 1024;      //!< Largest size class, in bytes
+    static constexpr size_t MAX_CACHED_BYTES = 1024 * 1024;  //!< Most bytes kept on one size class's free list
+
+    //! Allocate at least `size` bytes
+    static void *allocate(const size_t size);
+
+    //! Return a block obtained from allocate(`size`)
+    static void deallocate(void *block, const size_t size) noexcept;
+};
+
+//! \brief Reference-counted, immutable bytes shared by Buffer objects
+//! \details The reference count is not atomic: all the Buffers sharing one
+//! BufferStorage must be used by one thread at a time. Handing a Buffer to
+//! another thread is fine as long as the first thread keeps no copies.
+class BufferStorage {
+  private:
+    size_t _refs = 1;    //!< Number of Buffers sharing this storage
+    size_t _block_size;  //!< Bytes obtained from BufferPool for this object
+    std::string _owned;  //!< An adopted string (empty when the bytes are stored inline)
+    char *_data;         //!< The stored bytes
+    size_t _size;        //!< Number of stored bytes
+
+    BufferStorage(const size_t block_size, std::string &&owned);
+    BufferStorage(const size_t block_size, const size_t inline_size);
+    ~BufferStorage() = default;
+
+  public:
+    static constexpr size_t ADOPT_MIN_SIZE = 2048;  //!< Shorter strings are copied rather than adopted
+
+    //! Create storage that takes ownership of `str` (does not copy the bytes)
+    //! \details A short string, or one whose capacity is over twice its size, is copied into
+    //! pooled storage instead, so the memory held follows the bytes stored and not the
+    //! capacity of the strings that carried them (e.g. a 64 KiB read buffer holding a few bytes).
+    static BufferStorage *adopt(std::string &&str);
+
+    //! Create storage holding a copy of `data`, allocated together with the storage itself
+    static BufferStorage *copy_of(const std::string_view data);
+
+    //! Create storage of `size` uninitialized bytes, to be filled in through mutable_data() before sharing
+    static BufferStorage *create(const size_t size);
+
+    //! Writable pointer to the bytes of storage made by create()
+    char *mutable_data() noexcept { return _data; }
+
+    //! \returns the stored bytes
+    std::string_view bytes() const noexcept { return {_data, _size}; }
+
+    //! Add a reference
+    void retain() noexcept { ++_refs; }
+
+    //! Drop a reference, freeing the storage when none remain
+    void release() noexcept;
+
+    //! \name
+    //! Only handled by pointer
+    //!@{
+    BufferStorage(const BufferStorage &) = delete;
+    BufferStorage(BufferStorage &&) = delete;
+    BufferStorage &operator=(const BufferStorage &) = delete;
+    BufferStorage &operator=(BufferStorage &&) = delete;
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_BUFFER_STORAGE_HH
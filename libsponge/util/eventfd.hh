@@ -0,0 +1,25 @@
+#ifndef SPONGE_LIBSPONGE_EVENTFD_HH
+#define SPONGE_LIBSPONGE_EVENTFD_HH
+
+#include "file_descriptor.hh"
+
+//! A non-blocking [eventfd(2)](\ref man2::eventfd) used to wake up an EventLoop from another thread
+class EventFD : public FileDescriptor {
+  public:
+    //! Create a new eventfd whose counter starts at zero (i.e., not readable)
+    EventFD();
+
+    //! Make the descriptor readable until the next drain() (may be called from any thread)
+    void notify();
+
+    //! Reset the counter so the descriptor is no longer readable (only from the thread that polls it)
+    //! \returns `false` if there was nothing to drain
+    bool drain();
+};
+
+//! \class EventFD
+//! drain() counts as a read of the FileDescriptor, so an EventLoop callback that calls it
+//! satisfies the busy-wait check. notify() is usually called from another thread, so it
+//! leaves the FileDescriptor's (non-atomic) read and write counts alone.
+
+#endif  // SPONGE_LIBSPONGE_EVENTFD_HH
@@ -3,6 +3,7 @@
 #include "util.hh"
 
 #include <algorithm>
+#include <climits>
 #include <fcntl.h>
 #include <iostream>
 #include <stdexcept>
@@ -78,8 +79,9 @@ size_t FileDescriptor::write(BufferViewList buffer, const bool write_all) {
 
     do {
         auto iovecs = buffer.as_iovecs();
+        const size_t iovcnt = min(iovecs.size(), size_t(IOV_MAX));  // writev(2) rejects longer arrays
 
-        const ssize_t bytes_written = SystemCall("writev", ::writev(fd_num(), iovecs.data(), iovecs.size()));
+        const ssize_t bytes_written = SystemCall("writev", ::writev(fd_num(), iovecs.data(), iovcnt));
         if (bytes_written == 0 and buffer.size() != 0) {
             throw runtime_error("write returned 0 given non-empty input buffer");
         }
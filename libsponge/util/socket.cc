@@ -2,10 +2,17 @@
 
 #include "util.hh"
 
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
+#include <netinet/udp.h>
 #include <stdexcept>
 #include <unistd.h>
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103  // from linux/udp.h, for C libraries that predate it
+#endif
+
 using namespace std;
 
 // default constructor for socket of (subclassed) domain and type
@@ -141,6 +148,51 @@ void UDPSocket::send(const BufferViewList &payload) {
     register_write();
 }
 
+//! \param[in] destination is the address to send the datagrams to
+//! \param[in] payload is the bytes of all the datagrams, back to back
+//! \param[in] segment_size is the length of every datagram but the last
+//! \details The kernel refuses payloads over MAX_SEGMENTED_SIZE bytes or MAX_SEGMENTS datagrams,
+//! and kernels older than Linux 4.18 don't know the option at all; in those cases the caller
+//! has to send the datagrams one by one.
+bool UDPSocket::sendto_segmented(const Address &destination,
+                                 const BufferViewList &payload,
+                                 const size_t segment_size) {
+    if (segment_size == 0 or segment_size > UINT16_MAX or payload.size() > MAX_SEGMENTED_SIZE or
+        (payload.size() + segment_size - 1) / segment_size > MAX_SEGMENTS) {
+        return false;
+    }
+
+    auto iovecs = payload.as_iovecs();
+
+    msghdr message{};
+    message.msg_name = const_cast<sockaddr *>(static_cast<const sockaddr *>(destination));
+    message.msg_namelen = destination.size();
+    message.msg_iov = iovecs.data();
+    message.msg_iovlen = iovecs.size();
+
+    // the control message carrying the datagram size
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))]{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr *const cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t gso_size = segment_size;
+    memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+    const ssize_t bytes_sent = ::sendmsg(fd_num(), &message, 0);
+    if (bytes_sent < 0 and (errno == ENOPROTOOPT or errno == EINVAL or errno == EIO or errno == EOPNOTSUPP)) {
+        return false;
+    }
+    if (size_t(SystemCall("sendmsg", bytes_sent)) != payload.size()) {
+        throw runtime_error("datagram payload too big for sendmsg()");
+    }
+
+    register_write();
+    return true;
+}
+
 // mark the socket as listening for incoming connections
 //! \param[in] backlog is the number of waiting connections to queue (see [listen(2)](\ref man2::listen))
 void TCPSocket::listen(const int backlog) { SystemCall("listen", ::listen(fd_num(), backlog)); }
@@ -75,6 +75,14 @@ class UDPSocket : public Socket {
 
     //! Send datagram to the socket's connected address (must call connect() first)
     void send(const BufferViewList &payload);
+
+    static constexpr size_t MAX_SEGMENTED_SIZE = 65507;  //!< Most bytes one sendto_segmented() can carry
+    static constexpr size_t MAX_SEGMENTS = 64;           //!< Most datagrams one sendto_segmented() can make
+
+    //! \brief Send `payload` to specified Address as datagrams of `segment_size` bytes (the last may
+    //! be shorter), split by the kernel with [UDP_SEGMENT](\ref man7::udp)
+    //! \returns `false`, having sent nothing, if the kernel can't split this payload
+    bool sendto_segmented(const Address &destination, const BufferViewList &payload, const size_t segment_size);
 };
 
 //! \class UDPSocket
@@ -0,0 +1,40 @@
+#include "byte_stream.hh"
+#include "byte_stream_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            ByteStreamTestHarness test{"peek views across writes", 15};
+
+            test.execute(Write{"cat"});
+            test.execute(Write{"tac"});
+            test.execute(PeekViews{"catta"});
+            test.execute(PeekViews{"cattac"});
+
+            test.execute(Pop{2});
+            test.execute(PeekViews{"tta"});
+            test.execute(Write{"dog"});
+            test.execute(PeekViews{"ttacdog"});
+            test.execute(Peek{"ttacdog"});
+        }
+
+        {
+            ByteStreamTestHarness test{"peek views of an empty stream", 15};
+
+            test.execute(PeekViews{""});
+            test.execute(Write{"abc"});
+            test.execute(Pop{3});
+            test.execute(PeekViews{""});
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
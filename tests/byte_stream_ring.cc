@@ -0,0 +1,113 @@
+#include "byte_stream.hh"
+#include "byte_stream_test_harness.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            ByteStreamTestHarness test{"ring overwrite", 2, ByteStream::Storage::Ring};
+
+            test.execute(Write{"cat"}.with_bytes_written(2));
+            test.execute(RemainingCapacity{0});
+            test.execute(BufferSize{2});
+            test.execute(Peek{"ca"});
+            test.execute(Write{"t"}.with_bytes_written(0));
+            test.execute(Peek{"ca"});
+        }
+
+        {
+            ByteStreamTestHarness test{"ring wraparound", 5, ByteStream::Storage::Ring};
+
+            test.execute(Write{"abc"}.with_bytes_written(3));
+            test.execute(Pop{2});
+            test.execute(Write{"defg"}.with_bytes_written(4));
+            test.execute(BufferSize{5});
+            test.execute(RemainingCapacity{0});
+            test.execute(Peek{"cdefg"});
+            test.execute(PeekViews{"cdefg"});
+            test.execute(Pop{4});
+            test.execute(Write{"hij"}.with_bytes_written(3));
+            test.execute(Peek{"ghij"});
+            test.execute(PeekViews{"ghij"});
+            test.execute(BytesRead{6});
+            test.execute(BytesWritten{10});
+            test.execute(EndInput{});
+            test.execute(Pop{4});
+            test.execute(BufferEmpty{true});
+            test.execute(Eof{true});
+        }
+
+        {
+            ByteStream stream{6, ByteStream::Storage::Ring};
+            stream.write("abcd");
+            stream.pop_output(3);
+            stream.write("efgh");
+
+            const auto [first, second] = stream.peek_spans(4);
+            if (first != "def" or second != "g") {
+                throw runtime_error("ring peek_spans returned \"" + string(first) + "\", \"" + string(second) +
+                                    "\" instead of \"def\", \"g\"");
+            }
+            if (stream.read(10) != "defgh") {
+                throw runtime_error("ring read did not return the buffered bytes");
+            }
+        }
+
+        {
+            ByteStream stream{6, ByteStream::Storage::Ring};
+            stream.write("abcd");
+            stream.pop_output(3);
+            stream.write("efgh");
+
+            // the buffered bytes wrap around the end of the ring, and keep their order as it grows
+            stream.grow(10);
+            if (stream.remaining_capacity() != 5) {
+                throw runtime_error("ring didn't grow");
+            }
+            stream.write("ijklmn");
+            if (stream.read(20) != "defghijklm") {
+                throw runtime_error("ring lost its bytes as it grew");
+            }
+        }
+
+        {
+            auto rd = get_random_generator();
+            const size_t NREPS = 1000;
+            const size_t CAPACITY = 777;
+
+            ByteStreamTestHarness test{"ring many writes", CAPACITY, ByteStream::Storage::Ring};
+
+            size_t written = 0, read = 0;
+            for (size_t i = 0; i < NREPS; ++i) {
+                const size_t size = rd() % CAPACITY;
+                const size_t accepted = min(size, CAPACITY - (written - read));
+                string d(size, 0);
+                generate(d.begin(), d.end(), [&] { return 'a' + (rd() % 26); });
+
+                test.execute(Write{d}.with_bytes_written(accepted));
+                test.execute(Peek{d.substr(0, written == read ? accepted : 0)});
+                written += accepted;
+
+                const size_t popped = rd() % (written - read + 1);
+                test.execute(Pop{popped});
+                read += popped;
+
+                test.execute(BytesRead{read});
+                test.execute(BytesWritten{written});
+                test.execute(BufferSize{written - read});
+                test.execute(RemainingCapacity{CAPACITY - (written - read)});
+            }
+        }
+
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include "spsc_byte_stream.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+//! Block until `event` becomes readable, then reset it
+static void wait_for(EventFD &event) {
+    pollfd pfd{event.fd_num(), POLLIN, 0};
+    SystemCall("poll", ::poll(&pfd, 1, 1000));
+    event.drain();
+}
+
+int main() {
+    try {
+        {
+            SPSCByteStream stream{4};
+
+            if (stream.write("abcdef") != 4 or stream.remaining_capacity() != 0) {
+                throw runtime_error("write should stop at capacity");
+            }
+            if (not stream.data_event().drain()) {
+                throw runtime_error("write should signal the data event");
+            }
+            stream.pop_output(3);
+            if (not stream.space_event().drain()) {
+                throw runtime_error("pop should signal the space event");
+            }
+            if (stream.write("ef") != 2 or stream.peek_output(3) != "def") {
+                throw runtime_error("ring did not wrap around");
+            }
+            const auto [first, second] = stream.peek_spans(3);
+            if (first != "d" or second != "ef") {
+                throw runtime_error("peek_spans returned \"" + string(first) + "\", \"" + string(second) + "\"");
+            }
+            stream.end_input();
+            if (stream.eof() or stream.read(10) != "def" or not stream.eof()) {
+                throw runtime_error("eof should follow the last byte");
+            }
+        }
+
+        {
+            const size_t LEN = 4 * 1024 * 1024;
+            const size_t CAPACITY = 4093;
+
+            auto rd = get_random_generator();
+            string data(LEN, 0);
+            for (auto &ch : data) {
+                ch = rd();
+            }
+
+            SPSCByteStream stream{CAPACITY};
+
+            thread writer([&] {
+                auto wrd = get_random_generator();
+                size_t offset = 0;
+                while (offset < LEN) {
+                    const size_t len = min(LEN - offset, size_t(1 + wrd() % 1500));
+                    const size_t written = stream.write(string_view(data).substr(offset, len));
+                    offset += written;
+                    if (written == 0) {
+                        wait_for(stream.space_event());
+                    }
+                }
+                stream.end_input();
+            });
+
+            string received;
+            received.reserve(LEN);
+            while (not stream.eof()) {
+                if (stream.buffer_empty()) {
+                    wait_for(stream.data_event());
+                    continue;
+                }
+                received.append(stream.read(1 + rd() % 2000));
+            }
+            writer.join();
+
+            if (received != data) {
+                throw runtime_error("bytes read do not match bytes written");
+            }
+            if (stream.bytes_read() != LEN or stream.bytes_written() != LEN) {
+                throw runtime_error("byte counts do not match");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
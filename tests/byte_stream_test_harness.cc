@@ -45,11 +45,14 @@ void ByteStreamAction::execute(ByteStream &) const {}
 
 ByteStreamAction::~ByteStreamAction() {}
 
-ByteStreamTestHarness::ByteStreamTestHarness(const std::string &test_name, const size_t capacity)
-    : _test_name(test_name), _byte_stream(capacity) {
+ByteStreamTestHarness::ByteStreamTestHarness(const std::string &test_name,
+                                             const size_t capacity,
+                                             const ByteStream::Storage storage)
+    : _test_name(test_name), _byte_stream(capacity, storage) {
     std::ostringstream ss;
     ss << "Initialized with ("
-       << "capacity=" << capacity << ")";
+       << "capacity=" << capacity << ", storage=" << (storage == ByteStream::Storage::Ring ? "ring" : "chunked")
+       << ")";
     _steps_executed.emplace_back(ss.str());
 }
 
@@ -182,3 +185,17 @@ void Peek::execute(ByteStream &bs) const {
                                              output + "\"");
     }
 }
+
+// PeekViews
+PeekViews::PeekViews(const std::string &output) : _output(output) {}
+std::string PeekViews::description() const { return "\"" + _output + "\" viewed at the front of the stream"; }
+void PeekViews::execute(ByteStream &bs) const {
+    std::string output;
+    for (const auto &iov : bs.peek_views(_output.size()).as_iovecs()) {
+        output.append(static_cast<const char *>(iov.iov_base), iov.iov_len);
+    }
+    if (output != _output) {
+        throw ByteStreamExpectationViolation("Expected \"" + _output +
+                                             "\" viewed at the front of the stream, but found \"" + output + "\"");
+    }
+}
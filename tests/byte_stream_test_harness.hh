@@ -128,13 +128,23 @@ struct Peek : public ByteStreamExpectation {
     void execute(ByteStream &) const override;
 };
 
+struct PeekViews : public ByteStreamExpectation {
+    std::string _output;
+
+    PeekViews(const std::string &output);
+    std::string description() const override;
+    void execute(ByteStream &) const override;
+};
+
 class ByteStreamTestHarness {
     std::string _test_name;
     ByteStream _byte_stream;
     std::vector<std::string> _steps_executed{};
 
   public:
-    ByteStreamTestHarness(const std::string &test_name, const size_t capacity);
+    ByteStreamTestHarness(const std::string &test_name,
+                          const size_t capacity,
+                          const ByteStream::Storage storage = ByteStream::Storage::Chunked);
 
     void execute(const ByteStreamTestStep &step);
 };
@@ -0,0 +1,136 @@
+#include "tcp_config.hh"
+#include "tcp_expectation.hh"
+#include "tcp_fsm_test_harness.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "util.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//! a full-sized (100-byte) data segment from the peer
+static SendSegment full_segment(const WrappingInt32 seqno, const WrappingInt32 ackno) {
+    return SendSegment{}.with_ack(true).with_seqno(seqno).with_ackno(ackno).with_data(string(100, 'x'));
+}
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+        TCPConfig cfg{};
+        cfg.mss = 100;
+        cfg.delayed_ack = true;
+        const size_t delay = cfg.ack_delay;
+
+        // test 1: a lone full segment is acknowledged once the delay runs out
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_1 = TCPTestHarness::in_established(cfg, tx_isn, rx_isn);
+            test_1.execute(full_segment(rx_isn + 1, tx_isn + 1));
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: lone segment acknowledged at once");
+            test_1.execute(Tick{delay - 1});
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: ACK sent before the delay ran out");
+            test_1.execute(Tick{1});
+            test_1.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 101).with_payload_size(0),
+                           "test 1 failed: no ACK after the delay");
+            test_1.execute(Tick{10 * delay});
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: ACK sent twice");
+        }
+
+        // test 2: every second full segment is acknowledged at once
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_2 = TCPTestHarness::in_established(cfg, tx_isn, rx_isn);
+            for (unsigned int i = 0; i < 4; ++i) {
+                const WrappingInt32 seqno = rx_isn + 1 + 100 * i;
+                test_2.execute(full_segment(seqno, tx_isn + 1));
+                if (i % 2 == 0) {
+                    test_2.execute(ExpectNoSegment{}, "test 2 failed: first of a pair acknowledged at once");
+                } else {
+                    test_2.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 101 + 100 * i),
+                                   "test 2 failed: second of a pair not acknowledged");
+                }
+            }
+            test_2.execute(Tick{10 * delay});
+            test_2.execute(ExpectNoSegment{}, "test 2 failed: extra ACK after a pair");
+        }
+
+        // test 3: out-of-order data, the segment that fills the hole, and a FIN are acknowledged at once
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_3 = TCPTestHarness::in_established(cfg, tx_isn, rx_isn);
+            test_3.execute(full_segment(rx_isn + 101, tx_isn + 1));
+            test_3.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 1),
+                           "test 3 failed: out-of-order segment not acknowledged at once");
+            test_3.execute(full_segment(rx_isn + 1, tx_isn + 1));
+            test_3.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 201),
+                           "test 3 failed: hole-filling segment not acknowledged at once");
+            test_3.execute(ExpectData{}.with_data(string(200, 'x')));
+
+            test_3.execute(
+                SendSegment{}.with_ack(true).with_seqno(rx_isn + 201).with_ackno(tx_isn + 1).with_data("ab"));
+            test_3.execute(ExpectNoSegment{}, "test 3 failed: small segment acknowledged at once");
+            test_3.execute(
+                SendSegment{}.with_ack(true).with_fin(true).with_seqno(rx_isn + 203).with_ackno(tx_isn + 1));
+            test_3.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 204),
+                           "test 3 failed: FIN not acknowledged at once");
+        }
+
+        // test 4: outgoing data carries the delayed ACK, so no separate ACK follows
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_4 = TCPTestHarness::in_established(cfg, tx_isn, rx_isn);
+            test_4.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(rx_isn + 1)
+                               .with_ackno(tx_isn + 1)
+                               .with_win(1000)
+                               .with_data("request"));
+            test_4.execute(ExpectNoSegment{}, "test 4 failed: request acknowledged at once");
+            test_4.execute(Write{"response"});
+            test_4.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 8).with_data("response"),
+                           "test 4 failed: response doesn't acknowledge the request");
+            test_4.execute(Tick{delay});
+            test_4.execute(ExpectNoSegment{}, "test 4 failed: separate ACK after a piggybacked one");
+        }
+
+        // test 5: with delayed ACKs turned off, every segment is acknowledged at once
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPConfig cfg_off{};
+            TCPTestHarness test_5 = TCPTestHarness::in_established(cfg_off, tx_isn, rx_isn);
+            test_5.execute(SendSegment{}.with_ack(true).with_seqno(rx_isn + 1).with_ackno(tx_isn + 1).with_data("a"));
+            test_5.execute(ExpectOneSegment{}.with_ack(true).with_ackno(rx_isn + 2),
+                           "test 5 failed: segment not acknowledged at once");
+        }
+
+        // test 6: a full segment is the MSS in use, here the smaller one the peer's SYN asked for
+        {
+            const WrappingInt32 isn(rd());
+            TCPConfig cfg_big = cfg;
+            cfg_big.mss = 1000;
+            TCPTestHarness test_6(cfg_big);
+            test_6.execute(Listen{});
+            test_6.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_mss(100));
+            TCPSegment syn_ack = test_6.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 6 failed: no SYN/ACK");
+            const WrappingInt32 ack_base = syn_ack.header().seqno + 1;
+            test_6.execute(SendSegment{}.with_ack(true).with_seqno(isn + 1).with_ackno(ack_base).with_win(1000));
+
+            test_6.execute(full_segment(isn + 1, ack_base));
+            test_6.execute(ExpectNoSegment{}, "test 6 failed: first of a pair acknowledged at once");
+            test_6.execute(full_segment(isn + 101, ack_base));
+            test_6.execute(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 201),
+                           "test 6 failed: second of a pair not acknowledged");
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "tcp_config.hh"
+#include "tcp_expectation.hh"
+#include "tcp_fsm_test_harness.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using namespace std;
+using State = TCPTestHarness::State;
+
+//! accept a connection whose SYN carries `peer_mss` (if set), then return the largest payload sent for a write
+static size_t largest_payload(const TCPConfig &cfg, const optional<uint16_t> peer_mss) {
+    auto rd = get_random_generator();
+    const WrappingInt32 isn(rd());
+    TCPTestHarness test(cfg);
+    test.execute(Listen{});
+
+    SendSegment syn = SendSegment{}.with_syn(true).with_seqno(isn).with_win(UINT16_MAX);
+    syn.mss = peer_mss;
+    test.execute(syn);
+
+    TCPSegment syn_ack = test.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                         "SYN/ACK missing");
+    test_err_if(syn_ack.header().options.mss != optional<uint16_t>{cfg.mss}, "SYN/ACK doesn't advertise our MSS");
+
+    test.send_ack(isn + 1, syn_ack.header().seqno + 1, UINT16_MAX);
+    test.execute(ExpectState{State::ESTABLISHED});
+    test.execute(Write{string(10000, 'x')});
+    test.execute(Tick(1));
+
+    size_t largest = 0;
+    test.execute(ExpectSegmentAvailable{}, "nothing sent after write()");
+    while (test.can_read()) {
+        largest = max(largest, test.expect_seg(ExpectSegment{}.with_ack(true)).payload().size());
+    }
+    return largest;
+}
+
+int main() {
+    try {
+        TCPConfig cfg{};
+
+        // test 1: the peer's smaller MSS limits our segments
+        test_err_if(largest_payload(cfg, 536) != 536, "test 1 failed: peer's MSS not honoured");
+
+        // test 2: a larger peer MSS doesn't raise our own
+        test_err_if(largest_payload(cfg, 9000) != cfg.mss, "test 2 failed: segments larger than our MSS");
+
+        // test 3: without the option, our configured MSS applies
+        cfg.mss = 700;
+        test_err_if(largest_payload(cfg, {}) != 700, "test 3 failed: configured MSS not used");
+
+        // test 4: absurdly small MSS values are raised
+        test_err_if(largest_payload(cfg, 1) != TCPConfig::MIN_MSS, "test 4 failed: tiny MSS not raised");
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#include "tcp_config.hh"
+#include "tcp_expectation.hh"
+#include "tcp_fsm_test_harness.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "util.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using State = TCPTestHarness::State;
+
+static constexpr uint16_t WIN = 10000;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+        TCPConfig cfg{};
+        cfg.mss = 100;
+
+        // test 1: with Nagle's algorithm, small writes wait until everything sent is acknowledged
+        {
+            TCPConfig nagle_cfg = cfg;
+            nagle_cfg.nagle = true;
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_1 = TCPTestHarness::in_established(nagle_cfg, tx_isn, rx_isn);
+            test_1.send_ack(rx_isn + 1, tx_isn + 1, WIN);
+
+            test_1.execute(Write{"a"});
+            test_1.execute(ExpectOneSegment{}.with_seqno(tx_isn + 1).with_data("a"),
+                           "test 1 failed: nothing in flight, but a small segment was held");
+
+            test_1.execute(Write{"b"});
+            test_1.execute(Write{"c"});
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: small segment sent with data in flight");
+
+            // full-sized segments still go out; the small tail waits
+            test_1.execute(Write{string(250, 'd')});
+            test_1.execute(ExpectSegment{}.with_seqno(tx_isn + 2).with_payload_size(100));
+            test_1.execute(ExpectSegment{}.with_seqno(tx_isn + 102).with_payload_size(100));
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: small tail sent with data in flight");
+
+            test_1.send_ack(rx_isn + 1, tx_isn + 2, WIN);
+            test_1.execute(ExpectNoSegment{}, "test 1 failed: small tail sent before everything was acked");
+
+            test_1.send_ack(rx_isn + 1, tx_isn + 202, WIN);
+            test_1.execute(ExpectOneSegment{}.with_seqno(tx_isn + 202).with_payload_size(52),
+                           "test 1 failed: small tail not sent once everything was acked");
+
+            // the end of the stream isn't held back
+            test_1.execute(Write{"e"});
+            test_1.execute(ExpectNoSegment{});
+            test_1.execute(Close{});
+            test_1.execute(ExpectOneSegment{}.with_fin(true).with_data("e"),
+                           "test 1 failed: FIN held back by Nagle's algorithm");
+        }
+
+        // test 2: while corked, small writes wait even with nothing in flight
+        {
+            const WrappingInt32 tx_isn(rd()), rx_isn(rd());
+            TCPTestHarness test_2 = TCPTestHarness::in_established(cfg, tx_isn, rx_isn);
+            test_2.send_ack(rx_isn + 1, tx_isn + 1, WIN);
+
+            test_2.execute(Cork{});
+            test_2.execute(Write{"hello"});
+            test_2.execute(Write{string(145, 'x')});
+            test_2.execute(ExpectOneSegment{}.with_seqno(tx_isn + 1).with_payload_size(100),
+                           "test 2 failed: full segment held while corked");
+            test_2.execute(Tick(1));
+            test_2.execute(ExpectNoSegment{}, "test 2 failed: small segment sent while corked");
+
+            test_2.execute(Uncork{});
+            test_2.execute(ExpectOneSegment{}.with_seqno(tx_isn + 101).with_payload_size(50),
+                           "test 2 failed: held segment not sent on uncork");
+
+            test_2.execute(Write{"y"});
+            test_2.execute(ExpectOneSegment{}.with_data("y"), "test 2 failed: small segment held after uncork");
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#include "byte_stream.hh"
+#include "fsm_stream_reassembler_harness.hh"
+#include "stream_reassembler.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static constexpr auto BITMAP = StreamReassembler::Storage::Bitmap;
+
+int main() {
+    try {
+        {
+            ReassemblerTestHarness test{2, BITMAP};
+
+            test.execute(SubmitSegment{"bX", 1});
+            test.execute(BytesAssembled(0));
+            test.execute(UnassembledBytes(1));
+
+            test.execute(SubmitSegment{"a", 0});
+            test.execute(BytesAssembled(2));
+            test.execute(UnassembledBytes(0));
+
+            test.execute(BytesAvailable("ab"));
+        }
+
+        {
+            ReassemblerTestHarness test{8, BITMAP};
+
+            test.execute(SubmitSegment{"abcdef", 0});
+            test.execute(BytesAvailable("abcdef"));
+
+            // the window now wraps around the end of the ring
+            test.execute(SubmitSegment{"ijkl", 8}.with_eof(true));
+            test.execute(UnassembledBytes(4));
+            test.execute(SubmitSegment{"gh", 6});
+            test.execute(BytesAssembled(12));
+            test.execute(BytesAvailable("ghijkl"));
+            test.execute(AtEof{});
+        }
+
+        {
+            ReassemblerTestHarness test{65000, BITMAP};
+
+            test.execute(SubmitSegment{"c", 2});
+            test.execute(SubmitSegment{"bcd", 1});
+            test.execute(UnassembledBytes(3));
+            test.execute(SubmitSegment{"e", 4}.with_eof(true));
+            test.execute(NotAtEof{});
+            test.execute(SubmitSegment{"abc", 0});
+            test.execute(BytesAvailable("abcde"));
+            test.execute(AtEof{});
+        }
+
+        // growing keeps held bytes, including those that wrapped around the end of the ring
+        {
+            StreamReassembler bitmap{8, BITMAP};
+            bitmap.push_substring(string("abcdef"), 0, false);
+            bitmap.stream_out().pop_output(6);
+            bitmap.push_substring(string("ijkl"), 8, false);
+            bitmap.push_substring(string("nop"), 13, false);
+            if (bitmap.unassembled_bytes() != 5) {
+                throw runtime_error("bytes past the window held");
+            }
+
+            // the window now ends at 6 + 16, so "opq" fits
+            bitmap.grow(16);
+            if (bitmap.capacity() != 16 or bitmap.unassembled_bytes() != 5) {
+                throw runtime_error("held bytes lost as the ring grew");
+            }
+            bitmap.push_substring(string("opq"), 14, true);
+            bitmap.push_substring(string("ghijklm"), 6, false);
+            if (bitmap.stream_out().read(16) != "ghijklmnopq" or not bitmap.stream_out().eof()) {
+                throw runtime_error("wrong bytes assembled after the ring grew");
+            }
+        }
+
+        // both storages must assemble identical streams from the same segments
+        {
+            auto rd = get_random_generator();
+            const size_t capacity = 1000;
+            StreamReassembler map{capacity}, bitmap{capacity, BITMAP};
+
+            string d(64 * capacity, 0);
+            generate(d.begin(), d.end(), [&] { return rd(); });
+
+            string map_out, bitmap_out;
+            while (map_out.size() < d.size()) {
+                const size_t start = map_out.size() + rd() % capacity;
+                const size_t len = min(d.size() - min(start, d.size()), size_t(1 + rd() % 300));
+                if (start < d.size()) {
+                    map.push_substring(d.substr(start, len), start, start + len == d.size());
+                    bitmap.push_substring(d.substr(start, len), start, start + len == d.size());
+                }
+                if (map.unassembled_bytes() != bitmap.unassembled_bytes()) {
+                    throw runtime_error("unassembled byte counts diverged");
+                }
+                const size_t n = rd() % (map.stream_out().buffer_size() + 1);
+                map_out.append(map.stream_out().read(n));
+                bitmap_out.append(bitmap.stream_out().read(n));
+                if (map_out != bitmap_out) {
+                    throw runtime_error("assembled bytes diverged");
+                }
+            }
+            if (map_out != d or not bitmap.stream_out().eof()) {
+                throw runtime_error("content of RX bytes is incorrect");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "byte_stream.hh"
+#include "stream_reassembler.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static constexpr unsigned NREPS = 4;
+static constexpr unsigned NHOLES = 8192;
+static constexpr unsigned SEG_LEN = 16;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        // thousands of outstanding holes, filled by segments that overlap their neighbours
+        for (unsigned rep_no = 0; rep_no < NREPS; ++rep_no) {
+            const size_t total = 2 * NHOLES * SEG_LEN;
+            const auto storage = rep_no % 2 ? StreamReassembler::Storage::Bitmap : StreamReassembler::Storage::Map;
+            StreamReassembler buf{total, storage};
+
+            string d(total, 0);
+            generate(d.begin(), d.end(), [&] { return rd(); });
+
+            // every odd slot arrives first, leaving a hole in each even slot
+            vector<size_t> slots;
+            for (size_t i = 1; i < 2 * NHOLES; i += 2) {
+                slots.push_back(i);
+            }
+            shuffle(slots.begin(), slots.end(), rd);
+            for (const auto slot : slots) {
+                buf.push_substring(d.substr(slot * SEG_LEN, SEG_LEN), slot * SEG_LEN, (slot + 1) * SEG_LEN == total);
+            }
+            if (buf.unassembled_bytes() != NHOLES * SEG_LEN or buf.stream_out().bytes_written() != 0) {
+                throw runtime_error("odd slots should all be held unassembled");
+            }
+
+            // fill the holes from the back, each segment also covering parts of the slots around it
+            for (size_t i = 2 * NHOLES; i >= 2; i -= 2) {
+                const size_t slot = i - 2;
+                const size_t start = slot * SEG_LEN - min(slot * SEG_LEN, size_t(rd() % (SEG_LEN + 1)));
+                const size_t end = min(total, (slot + 1) * SEG_LEN + rd() % (2 * SEG_LEN));
+                buf.push_substring(d.substr(start, end - start), start, end == total);
+            }
+
+            if (buf.unassembled_bytes() != 0 or not buf.empty()) {
+                throw runtime_error("no bytes should remain unassembled");
+            }
+            if (buf.stream_out().bytes_written() != total or not buf.stream_out().input_ended()) {
+                throw runtime_error("number of RX bytes is incorrect");
+            }
+            if (buf.stream_out().read(total) != d) {
+                throw runtime_error("content of RX bytes is incorrect");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
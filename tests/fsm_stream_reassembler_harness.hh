@@ -164,8 +164,11 @@ class ReassemblerTestHarness {
     std::vector<std::string> steps_executed;
 
   public:
-    ReassemblerTestHarness(const size_t capacity) : reassembler(capacity), steps_executed() {
-        steps_executed.emplace_back("Initialized (capacity = " + std::to_string(capacity) + ")");
+    ReassemblerTestHarness(const size_t capacity,
+                           const StreamReassembler::Storage storage = StreamReassembler::Storage::Map)
+        : reassembler(capacity, storage), steps_executed() {
+        steps_executed.emplace_back("Initialized (capacity = " + std::to_string(capacity) + ", " +
+                                    (storage == StreamReassembler::Storage::Bitmap ? "bitmap" : "map") + ")");
     }
 
     void execute(const ReassemblerTestStep &step) {
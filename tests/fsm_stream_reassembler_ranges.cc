@@ -0,0 +1,129 @@
+#include "byte_stream.hh"
+#include "stream_reassembler.hh"
+#include "tcp_receiver.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+using Ranges = vector<pair<uint64_t, uint64_t>>;
+
+static string to_string(const Ranges &ranges) {
+    string ret;
+    for (const auto &[first, last] : ranges) {
+        ret += "[" + std::to_string(first) + ", " + std::to_string(last) + ") ";
+    }
+    return ret;
+}
+
+static void expect_ranges(const StreamReassembler &reassembler, const Ranges &expected, const string &what) {
+    if (reassembler.held_ranges() != expected) {
+        throw runtime_error(what + ": held_ranges() returned " + to_string(reassembler.held_ranges()) +
+                            "instead of " + to_string(expected));
+    }
+}
+
+int main() {
+    try {
+        for (const auto storage : {StreamReassembler::Storage::Map, StreamReassembler::Storage::Bitmap}) {
+            StreamReassembler buf{16, storage};
+
+            buf.push_substring("cd", 2, false);
+            buf.push_substring("ef", 4, false);
+            buf.push_substring("i", 8, false);
+            buf.push_substring("opqrstuvw", 14, false);
+            expect_ranges(buf, {{2, 6}, {8, 9}, {14, 16}}, "touching fragments merge");
+
+            buf.push_substring("ab", 0, false);
+            expect_ranges(buf, {{8, 9}, {14, 16}}, "assembled bytes are no longer held");
+
+            // the window wraps around the end of the bitmap ring
+            buf.stream_out().pop_output(6);
+            buf.push_substring("vw", 21, false);
+            expect_ranges(buf, {{8, 9}, {14, 16}, {21, 22}}, "held ranges follow the window");
+        }
+
+        {
+            StreamReassembler buf{1000, StreamReassembler::Storage::Map, 4};
+            string data(100, 0);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = 'a' + i % 26;
+            }
+
+            // touching 1-byte fragments are coalesced with the new byte rather than dropped
+            for (size_t i = 10; i < 20; ++i) {
+                buf.push_substring(data.substr(i, 1), i, false);
+            }
+            if (buf.fragments() > 4 or buf.unassembled_bytes() != 10) {
+                throw runtime_error("touching fragments should have been coalesced");
+            }
+            expect_ranges(buf, {{10, 20}}, "coalesced fragments");
+
+            buf.push_substring(data.substr(0, 10), 0, false);
+            if (buf.stream_out().buffer_size() != 20 or buf.stream_out().read(20) != data.substr(0, 20)) {
+                throw runtime_error("coalesced bytes are incorrect");
+            }
+        }
+
+        {
+            StreamReassembler buf{1000, StreamReassembler::Storage::Map, 4};
+            string data(100, 0);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = 'a' + i % 26;
+            }
+
+            // separate fragments beyond the cap are dropped, furthest first
+            for (const size_t i : {90, 70, 50, 30, 40}) {
+                buf.push_substring(data.substr(i, 1), i, false);
+            }
+            if (buf.fragments() != 4) {
+                throw runtime_error("fragment count should be capped at 4");
+            }
+            expect_ranges(buf, {{30, 31}, {40, 41}, {50, 51}, {70, 71}}, "evicted fragments");
+
+            // a push that fills the hole between two fragments is coalesced with both
+            buf.push_substring(data.substr(31, 9), 31, false);
+            if (buf.fragments() != 3) {
+                throw runtime_error("filled hole should have been coalesced");
+            }
+            expect_ranges(buf, {{30, 41}, {50, 51}, {70, 71}}, "hole filled between fragments");
+
+            // dropped bytes are taken again when resent, and everything is assembled in order
+            buf.push_substring(data, 0, true);
+            if (buf.unassembled_bytes() != 0 or buf.stream_out().read(100) != data or not buf.stream_out().eof()) {
+                throw runtime_error("bytes are incorrect after dropped fragments were resent");
+            }
+        }
+
+        {
+            const WrappingInt32 isn{UINT32_MAX - 2};
+            TCPReceiver receiver{100};
+
+            TCPSegment syn;
+            syn.header().syn = true;
+            syn.header().seqno = isn;
+            receiver.segment_received(syn);
+
+            TCPSegment seg;
+            seg.header().seqno = isn + 5;
+            seg.payload() = string("efg");
+            receiver.segment_received(seg);
+
+            const auto ranges = receiver.held_ranges();
+            if (ranges.size() != 1 or ranges[0].first != isn + 5 or ranges[0].second != isn + 8) {
+                throw runtime_error("receiver should report the held range in sequence number space");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
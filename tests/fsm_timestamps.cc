@@ -0,0 +1,227 @@
+#include "tcp_config.hh"
+#include "tcp_expectation.hh"
+#include "tcp_fsm_test_harness.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+#include "util.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using State = TCPTestHarness::State;
+
+//! the TSecr a segment echoes, failing the test if it carries no timestamps
+static uint32_t echoed(const TCPSegment &seg, const string &what) {
+    test_err_if(!seg.header().options.timestamps.has_value(), what + ": no timestamps");
+    return seg.header().options.timestamps->ecr;
+}
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+        TCPConfig cfg{};
+        cfg.timestamps = true;
+
+        // test 1: the peer's SYN offers timestamps, so every segment echoes its TSval, and
+        // segments with an older TSval than the last recorded are dropped (PAWS)
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_1(cfg);
+            test_1.execute(Listen{});
+            test_1.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_timestamps(100, 0));
+
+            TCPSegment syn_ack = test_1.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 1 failed: no SYN/ACK");
+            test_err_if(echoed(syn_ack, "test 1 failed: SYN/ACK") != 100,
+                        "test 1 failed: SYN/ACK doesn't echo the SYN");
+            const WrappingInt32 ack_base = syn_ack.header().seqno + 1;
+            const uint32_t our_ts = syn_ack.header().options.timestamps->val;
+
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_timestamps(105, our_ts));
+            test_1.execute(ExpectState{State::ESTABLISHED});
+
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("hello")
+                               .with_timestamps(110, our_ts));
+            TCPSegment ack = test_1.expect_seg(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 6),
+                                               "test 1 failed: data not acknowledged");
+            test_err_if(echoed(ack, "test 1 failed: ACK") != 110, "test 1 failed: ACK doesn't echo the data");
+
+            // an old duplicate by its timestamp: acknowledged, but not accepted
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 6)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("world")
+                               .with_timestamps(90, our_ts));
+            ack = test_1.expect_seg(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 6),
+                                    "test 1 failed: old duplicate accepted");
+            test_err_if(echoed(ack, "test 1 failed: ACK") != 110, "test 1 failed: old duplicate's TSval recorded");
+            test_1.execute(ExpectData{}.with_data("hello"));
+
+            // the same bytes with a current timestamp are accepted
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 6)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("world")
+                               .with_timestamps(120, our_ts));
+            ack = test_1.expect_seg(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 11),
+                                    "test 1 failed: data not acknowledged");
+            test_err_if(echoed(ack, "test 1 failed: ACK") != 120, "test 1 failed: ACK doesn't echo the data");
+            test_1.execute(ExpectData{}.with_data("world"));
+
+            // an out-of-order segment's TSval isn't recorded
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 20)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("later")
+                               .with_timestamps(130, our_ts));
+            ack = test_1.expect_seg(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 11),
+                                    "test 1 failed: out-of-order segment not acknowledged");
+            test_err_if(echoed(ack, "test 1 failed: ACK") != 120, "test 1 failed: out-of-order TSval recorded");
+        }
+
+        // test 2: the peer doesn't offer timestamps, so none are sent
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_2(cfg);
+            test_2.execute(Listen{});
+            test_2.send_syn(isn);
+
+            TCPSegment syn_ack = test_2.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 2 failed: no SYN/ACK");
+            test_err_if(syn_ack.header().options.timestamps.has_value(),
+                        "test 2 failed: SYN/ACK carries timestamps the peer didn't offer");
+
+            test_2.send_ack(isn + 1, syn_ack.header().seqno + 1, 1000);
+            test_2.execute(Write{"abc"});
+            TCPSegment data = test_2.expect_seg(ExpectOneSegment{}.with_data("abc"), "test 2 failed: no data");
+            test_err_if(data.header().options.timestamps.has_value(), "test 2 failed: data carries timestamps");
+        }
+
+        // test 3: active open; the SYN offers timestamps, and the ACK of the SYN/ACK echoes it
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_3(cfg);
+            test_3.execute(Connect{});
+            TCPSegment syn = test_3.expect_seg(ExpectOneSegment{}.with_no_flags().with_syn(true).with_payload_size(0),
+                                               "test 3 failed: no SYN");
+            test_err_if(echoed(syn, "test 3 failed: SYN") != 0, "test 3 failed: SYN echoes a timestamp");
+
+            test_3.execute(SendSegment{}
+                               .with_syn(true)
+                               .with_ack(true)
+                               .with_seqno(isn)
+                               .with_ackno(syn.header().seqno + 1)
+                               .with_win(1000)
+                               .with_timestamps(500, syn.header().options.timestamps->val));
+            TCPSegment ack = test_3.expect_seg(ExpectOneSegment{}.with_no_flags().with_ack(true).with_ackno(isn + 1),
+                                               "test 3 failed: no ACK of the SYN/ACK");
+            test_err_if(echoed(ack, "test 3 failed: ACK") != 500, "test 3 failed: ACK doesn't echo the SYN/ACK");
+            test_3.execute(ExpectState{State::ESTABLISHED});
+        }
+
+        // test 4: the timestamps come out of the MSS, so a full segment is no larger than without them
+        {
+            const WrappingInt32 isn(rd());
+            TCPConfig cfg_mss = cfg;
+            cfg_mss.mss = 100;
+            TCPTestHarness test_4(cfg_mss);
+            test_4.execute(Listen{});
+            test_4.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_timestamps(100, 0));
+            TCPSegment syn_ack = test_4.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 4 failed: no SYN/ACK");
+            test_4.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(syn_ack.header().seqno + 1)
+                               .with_win(1000)
+                               .with_timestamps(105, syn_ack.header().options.timestamps->val));
+
+            test_4.execute(Write{string(100, 'x')});
+            TCPSegment data = test_4.expect_seg(ExpectSegment{}.with_payload_size(88), "test 4 failed: first segment");
+            test_err_if(data.header().options.length() + data.payload().size() > cfg_mss.mss,
+                        "test 4 failed: payload and options exceed the MSS");
+            test_4.execute(ExpectSegment{}.with_payload_size(12), "test 4 failed: second segment");
+        }
+
+        // test 5: timestamps turned off, so the peer's offer is declined
+        {
+            const WrappingInt32 isn(rd());
+            TCPConfig cfg_off{};
+            TCPTestHarness test_5(cfg_off);
+            test_5.execute(Listen{});
+            test_5.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_timestamps(100, 0));
+            TCPSegment syn_ack = test_5.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 5 failed: no SYN/ACK");
+            test_err_if(syn_ack.header().options.timestamps.has_value(), "test 5 failed: SYN/ACK carries timestamps");
+        }
+
+        // test 6: a delayed ACK covering two segments echoes the earlier one's TSval, the one
+        // that started at the ackno last sent (RFC 7323 section 4.3)
+        {
+            const WrappingInt32 isn(rd());
+            TCPConfig cfg_delay = cfg;
+            cfg_delay.delayed_ack = true;
+            TCPTestHarness test_6(cfg_delay);
+            test_6.execute(Listen{});
+            test_6.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_timestamps(100, 0));
+            TCPSegment syn_ack = test_6.expect_seg(ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1),
+                                                   "test 6 failed: no SYN/ACK");
+            const WrappingInt32 ack_base = syn_ack.header().seqno + 1;
+            const uint32_t our_ts = syn_ack.header().options.timestamps->val;
+            test_6.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_timestamps(105, our_ts));
+
+            test_6.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("hello")
+                               .with_timestamps(110, our_ts));
+            test_6.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 6)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_data("world")
+                               .with_timestamps(120, our_ts));
+            test_6.execute(ExpectNoSegment{}, "test 6 failed: ACK not delayed");
+
+            test_6.execute(Tick{cfg_delay.ack_delay});
+            TCPSegment ack = test_6.expect_seg(ExpectOneSegment{}.with_ack(true).with_ackno(isn + 11),
+                                               "test 6 failed: no delayed ACK");
+            test_err_if(echoed(ack, "test 6 failed: ACK") != 110,
+                        "test 6 failed: delayed ACK doesn't echo the earlier segment");
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+#include "tcp_config.hh"
+#include "tcp_expectation.hh"
+#include "tcp_fsm_test_harness.hh"
+#include "tcp_header.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+#include "util.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using namespace std;
+using State = TCPTestHarness::State;
+
+static constexpr size_t RECV_CAPACITY = 1 << 20;  // needs a shift of 5 to fit in 16 bits
+
+//! read every segment the harness has, checking the ack fields, and return the payload bytes
+static size_t read_all(TCPTestHarness &test, const WrappingInt32 ackno, const uint16_t win, const string &what) {
+    size_t bytes = 0;
+    test.execute(ExpectSegmentAvailable{}, what + ": nothing sent");
+    while (test.can_read()) {
+        bytes += test.expect_seg(ExpectSegment{}.with_ack(true).with_ackno(ackno).with_win(win), what)
+                     .payload()
+                     .size();
+    }
+    return bytes;
+}
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+        TCPConfig cfg{};
+        cfg.recv_capacity = RECV_CAPACITY;
+        cfg.send_capacity = 1 << 17;
+        cfg.window_scaling = true;
+
+        // test 1: both SYNs offer window scaling, so later windows are scaled both ways
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_1(cfg);
+            test_1.execute(Listen{});
+            test_1.execute(SendSegment{}.with_syn(true).with_seqno(isn).with_win(1000).with_wscale(2));
+
+            TCPSegment syn_ack = test_1.expect_seg(
+                ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1).with_win(UINT16_MAX),
+                "test 1 failed: no SYN/ACK with an unscaled window");
+            test_err_if(syn_ack.header().options.wscale != optional<uint8_t>{5},
+                        "test 1 failed: SYN/ACK doesn't carry our window scale");
+            const WrappingInt32 ack_base = syn_ack.header().seqno + 1;
+
+            // a window of 1000 scaled by 4
+            test_1.send_ack(isn + 1, ack_base, 1000);
+            test_1.execute(ExpectState{State::ESTABLISHED});
+            test_1.execute(Write{string(10000, 'x')});
+            test_1.execute(Tick(1));
+            test_err_if(read_all(test_1, isn + 1, RECV_CAPACITY >> 5, "test 1 failed: bad data segment") != 4000,
+                        "test 1 failed: peer's window not scaled");
+
+            test_1.execute(SendSegment{}
+                               .with_ack(true)
+                               .with_seqno(isn + 1)
+                               .with_ackno(ack_base + 4000)
+                               .with_win(1000)
+                               .with_data(string(1000, 'y')));
+            test_1.execute(Tick(1));
+            test_err_if(
+                read_all(test_1, isn + 1001, (RECV_CAPACITY - 1000) >> 5, "test 1 failed: window not scaled") != 4000,
+                "test 1 failed: freed window not filled");
+        }
+
+        // test 2: the peer doesn't offer window scaling, so windows stay unscaled
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_2(cfg);
+            test_2.execute(Listen{});
+            test_2.send_syn(isn);
+
+            TCPSegment syn_ack = test_2.expect_seg(
+                ExpectOneSegment{}.with_syn(true).with_ack(true).with_ackno(isn + 1).with_win(UINT16_MAX),
+                "test 2 failed: no SYN/ACK");
+            test_err_if(syn_ack.header().options.wscale.has_value(),
+                        "test 2 failed: SYN/ACK carries a window scale the peer didn't offer");
+            const WrappingInt32 ack_base = syn_ack.header().seqno + 1;
+
+            test_2.send_ack(isn + 1, ack_base, 1000);
+            test_2.execute(Write{string(10000, 'x')});
+            test_2.execute(Tick(1));
+            test_err_if(read_all(test_2, isn + 1, UINT16_MAX, "test 2 failed: bad data segment") != 1000,
+                        "test 2 failed: peer's window scaled without negotiation");
+        }
+
+        // test 3: active open; the SYN offers scaling and the SYN/ACK's own window is unscaled
+        {
+            const WrappingInt32 isn(rd());
+            TCPTestHarness test_3(cfg);
+            test_3.execute(Connect{});
+            TCPSegment syn = test_3.expect_seg(ExpectOneSegment{}.with_no_flags().with_syn(true).with_payload_size(0),
+                                               "test 3 failed: no SYN");
+            test_err_if(syn.header().options.wscale != optional<uint8_t>{5},
+                        "test 3 failed: SYN doesn't offer window scaling");
+            const WrappingInt32 ack_base = syn.header().seqno + 1;
+
+            test_3.execute(SendSegment{}
+                               .with_syn(true)
+                               .with_ack(true)
+                               .with_seqno(isn)
+                               .with_ackno(ack_base)
+                               .with_win(1000)
+                               .with_wscale(3));
+            test_3.execute(
+                ExpectOneSegment{}.with_no_flags().with_ack(true).with_ackno(isn + 1).with_win(RECV_CAPACITY >> 5),
+                "test 3 failed: ACK of the SYN/ACK has a bad window");
+            test_3.execute(ExpectState{State::ESTABLISHED});
+
+            test_3.execute(Write{string(20000, 'x')});
+            test_3.execute(Tick(1));
+            test_err_if(read_all(test_3, isn + 1, RECV_CAPACITY >> 5, "test 3 failed: bad data segment") != 1000,
+                        "test 3 failed: SYN/ACK's window was scaled");
+
+            test_3.send_ack(isn + 1, ack_base + 1000, 1000);
+            test_3.execute(Tick(1));
+            test_err_if(read_all(test_3, isn + 1, RECV_CAPACITY >> 5, "test 3 failed: bad data segment") != 8000,
+                        "test 3 failed: peer's window not scaled");
+        }
+
+        // test 4: scaling is off by default, so the SYN offers none and the window is capped at 64 KiB
+        {
+            TCPConfig cfg_off{};
+            cfg_off.recv_capacity = RECV_CAPACITY;
+            TCPTestHarness test_4(cfg_off);
+            test_4.execute(Connect{});
+            TCPSegment syn = test_4.expect_seg(ExpectOneSegment{}.with_no_flags().with_syn(true).with_payload_size(0),
+                                               "test 4 failed: no SYN");
+            test_err_if(syn.header().options.wscale.has_value(), "test 4 failed: SYN offers window scaling");
+
+            const WrappingInt32 isn(rd());
+            test_4.execute(SendSegment{}
+                               .with_syn(true)
+                               .with_ack(true)
+                               .with_seqno(isn)
+                               .with_ackno(syn.header().seqno + 1)
+                               .with_win(1000)
+                               .with_wscale(3));
+            test_4.execute(ExpectOneSegment{}.with_no_flags().with_ack(true).with_ackno(isn + 1).with_win(UINT16_MAX),
+                           "test 4 failed: ACK of the SYN/ACK has a bad window");
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
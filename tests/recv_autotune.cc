@@ -0,0 +1,168 @@
+#include "tcp_receiver.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+#include "util.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//! a receiver that has had a SYN at `isn`, with its window auto-tuned between 1000 and 8000 bytes
+class Autotuned {
+    WrappingInt32 _isn;
+    uint64_t _edge{0};
+
+  public:
+    TCPReceiver receiver{1000, StreamReassembler::Storage::Map, 0, 8000};
+
+    explicit Autotuned(const WrappingInt32 isn) : _isn(isn) {
+        TCPSegment syn;
+        syn.header().syn = true;
+        syn.header().seqno = isn;
+        receiver.segment_received(syn);
+        check_edge();
+    }
+
+    //! the right edge of the window, in stream bytes, which must never move left
+    uint64_t check_edge() {
+        const uint64_t edge = receiver.stream_out().bytes_written() + receiver.window_size();
+        test_err_if(edge < _edge, "right edge moved left from " + to_string(_edge) + " to " + to_string(edge));
+        _edge = edge;
+        return edge;
+    }
+
+    //! the next `n` bytes of the stream arrive
+    void deliver(const size_t n) {
+        TCPSegment seg;
+        seg.header().seqno = _isn + 1 + receiver.stream_out().bytes_written();
+        seg.payload() = string(n, 'x');
+        receiver.segment_received(seg);
+        check_edge();
+    }
+
+    //! the application reads everything
+    void read() {
+        receiver.stream_out().read(receiver.stream_out().buffer_size());
+        check_edge();
+    }
+
+    void tune(const size_t ms, const uint64_t rtt) {
+        receiver.tune_window(ms, rtt);
+        check_edge();
+    }
+};
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        // an application that reads everything at once doubles the window each RTT, up to the bound
+        {
+            Autotuned a{WrappingInt32(rd())};
+            test_err_if(a.receiver.window_size() != 1000, "window doesn't start at the least capacity");
+            test_err_if(a.receiver.capacity_max() != 8000, "wrong greatest capacity");
+
+            a.deliver(1000);
+            a.read();
+            a.tune(10, 0);
+            test_err_if(a.receiver.window_size() != 1000, "window tuned without an RTT");
+
+            size_t expected = 1000;
+            for (unsigned round = 0; round < 4; ++round) {
+                if (round) {
+                    a.deliver(expected);
+                    a.read();
+                }
+                a.tune(5, 10);
+                test_err_if(a.receiver.window_size() != expected, "window tuned before an RTT passed");
+                a.tune(5, 10);
+                expected = min<size_t>(2 * expected, 8000);
+                test_err_if(a.receiver.window_size() != expected,
+                            "round " + to_string(round) + ": window " + to_string(a.receiver.window_size()) +
+                                ", expected " + to_string(expected));
+            }
+
+            // once the application stops reading, the capacity shrinks, but the right edge stays put
+            const uint64_t edge = a.check_edge();
+            a.tune(10, 10);
+            a.tune(10, 10);
+            test_err_if(a.check_edge() != edge, "right edge moved as the capacity shrank");
+
+            a.deliver(3000);
+            test_err_if(a.receiver.window_size() != 5000, "window doesn't reach the advertised edge");
+            a.read();
+            test_err_if(a.check_edge() != edge, "right edge moved past the shrunken capacity");
+
+            // shrinking stops at the least capacity
+            for (unsigned round = 0; round < 20; ++round)
+                a.tune(10, 10);
+            a.deliver(a.receiver.window_size());
+            a.read();
+            test_err_if(a.receiver.window_size() != 1000, "capacity shrank below its bound");
+        }
+
+        // the buffers start at the least capacity, and bytes past the window are dropped even
+        // once the buffers have grown beyond it
+        {
+            const WrappingInt32 isn(rd());
+            Autotuned a{isn};
+            test_err_if(a.receiver.stream_out().remaining_capacity() != 1000,
+                        "buffers sized for the greatest capacity");
+
+            const auto arrive = [&](const uint64_t index, const size_t n) {
+                TCPSegment seg;
+                seg.header().seqno = isn + 1 + index;
+                seg.payload() = string(n, 'x');
+                a.receiver.segment_received(seg);
+            };
+            arrive(900, 300);
+            test_err_if(a.receiver.unassembled_bytes() != 100, "out-of-order bytes held past the window");
+            arrive(0, 1200);
+            test_err_if(a.receiver.stream_out().bytes_written() != 1000, "in-order bytes accepted past the window");
+
+            // the application reads 2000 bytes in an RTT, so the window grows to 4000
+            a.read();
+            a.deliver(1000);
+            a.read();
+            a.tune(10, 10);
+            test_err_if(a.receiver.window_size() != 4000, "window didn't grow");
+            test_err_if(a.receiver.stream_out().remaining_capacity() != 4000, "buffers didn't grow with the window");
+
+            // the application stops reading, so the capacity shrinks to 3000; the buffers don't,
+            // but bytes past the window (here, past 5000 + 3000) are still dropped
+            a.tune(10, 10);
+            arrive(2000, 3000);
+            a.read();
+            arrive(5000, 4000);
+            test_err_if(a.receiver.stream_out().bytes_written() != 8000, "bytes accepted past the window");
+            test_err_if(a.receiver.window_size() != 0, "window left open past the shrunken capacity");
+        }
+
+        // without auto-tuning, the window is the room left in the stream
+        {
+            const WrappingInt32 isn(rd());
+            TCPReceiver receiver{1000};
+            TCPSegment syn;
+            syn.header().syn = true;
+            syn.header().seqno = isn;
+            receiver.segment_received(syn);
+            TCPSegment seg;
+            seg.header().seqno = isn + 1;
+            seg.payload() = string(400, 'x');
+            receiver.segment_received(seg);
+            receiver.tune_window(100, 10);
+            test_err_if(receiver.window_size() != 600, "window tuned without auto-tuning");
+            test_err_if(receiver.capacity_max() != 1000, "wrong greatest capacity");
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
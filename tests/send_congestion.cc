@@ -0,0 +1,118 @@
+#include "congestion_control.hh"
+#include "sender_harness.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.congestion_control = CongestionControl::Algorithm::NewReno;
+
+            TCPSenderTestHarness test{"NewReno slow start, timeout and congestion avoidance", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{10000});
+
+            test.execute(WriteBytes{string(60000, 'a')});
+            test.execute(ExpectBytesInFlight{10000});
+
+            // slow start: each ACK grows the window by what it acknowledges, up to two segments
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 2000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{12000});
+            test.execute(ExpectBytesInFlight{12000});
+
+            // a timeout halves the flight into ssthresh and restarts from one segment
+            test.execute(Tick{TCPConfig::TIMEOUT_DFLT});
+            test.execute(ExpectCongestionWindow{1000});
+
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 14000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{3000});
+            test.execute(ExpectBytesInFlight{3000});
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 17000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{5000});
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 22000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{7000});
+
+            // above ssthresh (6000), one segment per window of acknowledged bytes
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 26000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{7000});
+            test.execute(AckReceived{WrappingInt32{isn + 1 + 29000}}.with_win(60000));
+            test.execute(ExpectCongestionWindow{8000});
+            test.execute(ExpectBytesInFlight{8000});
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.congestion_control = CongestionControl::Algorithm::NewReno;
+
+            TCPSenderTestHarness test{"Receiver window still applies under congestion control", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(3000));
+            test.execute(WriteBytes{string(60000, 'a')});
+            test.execute(ExpectBytesInFlight{3000});
+        }
+
+        {
+            const size_t mss = TCPConfig::MAX_PAYLOAD_SIZE;
+            Cubic cubic{mss};
+
+            // leave slow start with a loss at a 20-segment window
+            while (cubic.cwnd() < 20 * mss) {
+                cubic.on_ack(mss, 0);
+            }
+            cubic.on_loss(cubic.cwnd(), 0);
+            if (cubic.cwnd() != 14 * mss or cubic.ssthresh() != 14 * mss) {
+                throw runtime_error("CUBIC should reduce the window by a factor of 0.7");
+            }
+
+            // one window acknowledged per 500 ms round trip: the window regrows toward 20
+            // segments, levels off there, then probes beyond
+            uint64_t last = cubic.cwnd();
+            uint64_t at_plateau = 0;
+            for (uint64_t now = 0; now <= 6000; now += 500) {
+                for (uint64_t acked = 0; acked < cubic.cwnd(); acked += mss) {
+                    cubic.on_ack(mss, now);
+                }
+                if (cubic.cwnd() < last) {
+                    throw runtime_error("CUBIC window shrank without a loss");
+                }
+                last = cubic.cwnd();
+                if (now == 2500) {
+                    at_plateau = last;
+                }
+            }
+            if (at_plateau < 19 * mss or at_plateau > 22 * mss) {
+                throw runtime_error("CUBIC should level off near the window of the last loss, not at " +
+                                    to_string(at_plateau));
+            }
+            if (last <= 25 * mss) {
+                throw runtime_error("CUBIC should probe beyond the window of the last loss");
+            }
+
+            cubic.on_timeout(cubic.cwnd(), 6000);
+            if (cubic.cwnd() != mss) {
+                throw runtime_error("CUBIC should restart from one segment after a timeout");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#include "congestion_control.hh"
+#include "sender_harness.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.fast_retransmit = true;
+
+            TCPSenderTestHarness test{"Third duplicate ack retransmits", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(WriteBytes{"abcdefgh"});
+            test.execute(ExpectSegment{}.with_data("abcdefgh"));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(ExpectNoSegment{});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(ExpectSegment{}.with_data("abcdefgh").with_seqno(isn + 1));
+            test.execute(ExpectNoSegment{});
+
+            // further duplicates during recovery don't resend it again
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(ExpectNoSegment{});
+            test.execute(AckReceived{WrappingInt32{isn + 9}}.with_win(1000));
+            test.execute(ExpectBytesInFlight{0});
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.fast_retransmit = true;
+
+            TCPSenderTestHarness test{"A window update is not a duplicate ack", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(WriteBytes{"abcdefgh"});
+            test.execute(ExpectSegment{}.with_data("abcdefgh"));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(999));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(998));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(997));
+            test.execute(ExpectNoSegment{});
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.fast_retransmit = true;
+            cfg.mss = 100;
+
+            TCPSenderTestHarness test{"Duplicate acks for data sent before a timeout don't retransmit", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(WriteBytes{string(300, 'x')});
+            for (uint32_t i = 0; i < 3; ++i) {
+                test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1 + 100 * i));
+            }
+            test.execute(Tick{cfg.rt_timeout});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+
+            // the rest of the pre-timeout flight was lost, and later arrivals from it only duplicate
+            test.execute(AckReceived{WrappingInt32{isn + 101}}.with_win(1000));
+            for (int i = 0; i < 3; ++i) {
+                test.execute(AckReceived{WrappingInt32{isn + 101}}.with_win(1000));
+            }
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{cfg.rt_timeout});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 101));
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.fast_retransmit = true;
+            cfg.congestion_control = CongestionControl::Algorithm::NewReno;
+            const auto seqno = [&](const uint32_t offset) { return WrappingInt32{isn + 1 + offset}; };
+
+            TCPSenderTestHarness test{"NewReno fast recovery", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(AckReceived{seqno(0)}.with_win(60000));
+            test.execute(WriteBytes{string(30000, 'x')});
+            for (uint32_t i = 0; i < 10; ++i) {
+                test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(1000 * i)));
+            }
+            test.execute(AckReceived{seqno(2000)}.with_win(60000));
+            test.execute(ExpectBytesInFlight{12000});
+            for (uint32_t i = 10; i < 14; ++i) {
+                test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(1000 * i)));
+            }
+
+            // the third duplicate resends the hole; the window drops to half the flight (6000)
+            // but is inflated by the three segments that have left the network
+            for (int i = 0; i < 3; ++i) {
+                test.execute(AckReceived{seqno(2000)}.with_win(60000));
+            }
+            test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(2000)));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{6000});
+
+            // each further duplicate lets one more segment out once the inflated window passes the flight
+            for (int i = 0; i < 3; ++i) {
+                test.execute(AckReceived{seqno(2000)}.with_win(60000));
+            }
+            test.execute(ExpectNoSegment{});
+            test.execute(AckReceived{seqno(2000)}.with_win(60000));
+            test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(14000)));
+            test.execute(ExpectNoSegment{});
+
+            // a partial ack resends the next hole at once and stays in recovery
+            test.execute(AckReceived{seqno(6000)}.with_win(60000));
+            test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(6000)));
+            test.execute(ExpectSegment{}.with_payload_size(1000).with_seqno(seqno(15000)));
+            test.execute(ExpectNoSegment{});
+
+            // acking everything sent before the loss ends recovery at ssthresh
+            test.execute(AckReceived{seqno(15000)}.with_win(60000));
+            test.execute(ExpectCongestionWindow{6000});
+            test.execute(ExpectBytesInFlight{6000});
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include "tcp_config.hh"
+#include "tcp_segment.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static TCPSegment pop(TCPSender &sender) {
+    test_err_if(sender.segments_out().empty(), "no segment sent");
+    TCPSegment seg = sender.segments_out().front();
+    sender.segments_out().pop();
+    return seg;
+}
+
+int main() {
+    try {
+        const WrappingInt32 isn{0xfffffff0};  // the pieces' seqnos wrap around
+        TCPConfig cfg;
+        cfg.fixed_isn = isn;
+        cfg.mss = 100;
+        cfg.gso_segments = 4;
+
+        string data(350, 'x');
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>('a' + i % 26);
+        }
+
+        // the SYN goes out alone
+        TCPSender sender{cfg};
+        sender.fill_window();
+        test_err_if(pop(sender).is_super_segment(), "SYN sent as a super-segment");
+        sender.ack_received(isn + 1, 1000);
+
+        // then one super-segment carries all the data and the FIN
+        sender.stream_in().write(string(data));
+        sender.stream_in().end_input();
+        sender.fill_window();
+        TCPSegment seg = pop(sender);
+        test_err_if(!sender.segments_out().empty(), "more than one segment sent");
+        test_err_if(!seg.is_super_segment() || seg.gso_size() != 100, "not a super-segment of the MSS");
+        test_err_if(seg.payload().size() != 350 || !seg.header().fin, "super-segment doesn't hold everything");
+
+        // split, each piece is an MSS (the last shorter), in sequence and with the FIN at the end
+        vector<TCPSegment> pieces;
+        seg.split([&](TCPSegment &piece) { pieces.push_back(piece); });
+        test_err_if(pieces.size() != 4, "wrong number of pieces");
+        string joined;
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            const TCPHeader &header = pieces[i].header();
+            test_err_if(pieces[i].is_super_segment(), "piece still needs splitting");
+            test_err_if(header.seqno != isn + 1 + 100 * i, "piece has the wrong seqno");
+            test_err_if(header.fin != (i == 3), "FIN on the wrong piece");
+            test_err_if(pieces[i].payload().size() != (i == 3 ? 50 : 100), "piece has the wrong size");
+
+            // each piece gets its own checksum, and parses back as sent
+            TCPSegment parsed;
+            test_err_if(parsed.parse(pieces[i].serialize(0).concatenate()) != ParseResult::NoError,
+                        "piece doesn't parse");
+            test_err_if(!(parsed.header() == header), "piece header changed on the wire");
+            joined += parsed.payload().copy();
+        }
+        test_err_if(joined != data, "pieces don't add up to the data");
+
+        // a segment that isn't a super-segment is passed through as is
+        size_t calls = 0;
+        pieces[0].split([&](TCPSegment &piece) { calls += (&piece == &pieces[0]); });
+        test_err_if(calls != 1, "ordinary segment was split");
+
+        // on timeout, only the first unacknowledged MSS is resent
+        sender.tick(cfg.rt_timeout);
+        TCPSegment retx = pop(sender);
+        test_err_if(retx.header().seqno != isn + 1 || retx.payload().size() != 100 || retx.header().fin,
+                    "timeout resent the wrong piece");
+
+        // an ack of part of the super-segment restarts the timer and ends the backoff, and the
+        // retransmission starts at the ackno
+        sender.ack_received(isn + 151, 1000);
+        test_err_if(sender.consecutive_retransmissions() != 0, "partial ack didn't end the backoff");
+        sender.tick(cfg.rt_timeout - 1);
+        test_err_if(!sender.segments_out().empty(), "timer not restarted by a partial ack");
+        sender.tick(1);
+        retx = pop(sender);
+        test_err_if(retx.header().seqno != isn + 151 || retx.payload().size() != 100, "resent from the wrong place");
+        test_err_if(retx.payload().copy() != data.substr(150, 100), "resent the wrong bytes");
+
+        sender.ack_received(isn + 301, 1000);
+        sender.tick(cfg.rt_timeout);
+        retx = pop(sender);
+        test_err_if(retx.header().seqno != isn + 301 || retx.payload().size() != 50 || !retx.header().fin,
+                    "last piece resent without the FIN");
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
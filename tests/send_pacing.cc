@@ -0,0 +1,116 @@
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_err_if.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//! the sequence numbers in the segments the sender has queued, which are then dropped
+static size_t drain(TCPSender &sender) {
+    size_t sent = 0;
+    while (!sender.segments_out().empty()) {
+        sent += sender.segments_out().front().length_in_sequence_space();
+        sender.segments_out().pop();
+    }
+    return sent;
+}
+
+//! a sender past the handshake, with a 10 ms RTT measured and a 10000-byte window
+static TCPSender established(const TCPConfig &cfg) {
+    TCPSender sender{cfg};
+    sender.fill_window();
+    drain(sender);
+    sender.tick(10);
+    sender.ack_received(cfg.fixed_isn.value() + 1, 10000);
+    return sender;
+}
+
+int main() {
+    try {
+        TCPConfig cfg;
+        cfg.fixed_isn = WrappingInt32{12345};
+        cfg.mss = 100;
+
+        // unpaced, the whole window goes out at once
+        {
+            TCPSender sender = established(cfg);
+            sender.stream_in().write(string(20000, 'x'));
+            sender.fill_window();
+            test_err_if(drain(sender) != 10000, "unpaced sender didn't fill the window");
+            test_err_if(sender.pacing_rate() != 0 || sender.pacing_delay() != 0, "unpaced sender has a rate");
+        }
+
+        // paced, a 10000-byte window over 10 ms (plus a quarter) is 1250 bytes each millisecond
+        cfg.pacing = true;
+        {
+            TCPSender sender = established(cfg);
+            test_err_if(sender.pacing_rate() != 1'250'000, "wrong pacing rate");
+
+            sender.stream_in().write(string(20000, 'x'));
+            sender.fill_window();
+            test_err_if(drain(sender) != 0, "paced sender sent without credit");
+            test_err_if(sender.pacing_delay() != 1, "wrong delay until the next segment");
+
+            size_t sent = 0;
+            for (size_t ms = 1; ms <= 4; ++ms) {
+                sender.tick(1);
+                const size_t now = drain(sender);
+                test_err_if(now < 1200 || now > 1400, "wrong burst in one millisecond: " + to_string(now));
+                sent += now;
+            }
+
+            // idle time doesn't save up into a burst larger than a millisecond's worth
+            sender.tick(50);
+            test_err_if(drain(sender) > 1400, "pacer released a burst after idling");
+            test_err_if(sent + 1400 < 5000, "paced sender fell behind its rate");
+        }
+
+        // the cap holds the rate down, even before an RTT is measured
+        cfg.pacing_rate_max = 200'000;
+        {
+            TCPSender sender{cfg};
+            sender.fill_window();
+            drain(sender);
+            test_err_if(sender.pacing_rate() != 200'000, "cap doesn't pace before an RTT sample");
+
+            sender.tick(10);
+            sender.ack_received(cfg.fixed_isn.value() + 1, 10000);
+            test_err_if(sender.pacing_rate() != 200'000, "cap not applied");
+
+            sender.stream_in().write(string(2000, 'x'));
+            sender.fill_window();
+            drain(sender);
+            size_t sent = 0;
+            for (size_t ms = 1; ms <= 5; ++ms) {
+                sender.tick(1);
+                sent += drain(sender);
+            }
+            test_err_if(sent < 800 || sent > 1200, "capped rate not kept: " + to_string(sent));
+        }
+
+        // a rate below a byte per millisecond still adds up over many short ticks
+        cfg.pacing_rate_max = 500;
+        {
+            TCPSender sender = established(cfg);
+            sender.stream_in().write(string(2000, 'x'));
+            sender.fill_window();
+            size_t sent = drain(sender);
+            for (size_t ms = 1; ms <= 1000; ++ms) {
+                sender.tick(1);
+                sent += drain(sender);
+            }
+            test_err_if(sent < 400 || sent > 700, "slow rate not kept over short ticks: " + to_string(sent));
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+#include "sender_harness.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.rack_tlp = true;
+
+            TCPSenderTestHarness test{"A lone tail segment is probed after 2 SRTT plus the delayed-ACK time", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));  // SRTT 10
+            test.execute(WriteBytes{"abc"});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{219});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("abc").with_seqno(isn + 1));
+
+            // one probe per tail: the next resend waits for the RTO, which the probe restarted
+            test.execute(Tick{999});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("abc").with_seqno(isn + 1));
+
+            test.execute(AckReceived{WrappingInt32{isn + 4}}.with_win(1000));
+            test.execute(Tick{5000});
+            test.execute(ExpectNoSegment{});
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.mss = 100;
+
+            TCPSenderTestHarness test{"Without RACK-TLP, a lost tail waits for the RTO", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));
+            test.execute(WriteBytes{string(200, 'x')});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 101));
+            test.execute(Tick{999});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.mss = 100;
+            cfg.rack_tlp = true;
+
+            TCPSenderTestHarness test{"The last segment is probed, and RACK resends what the RTO left behind", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));  // SRTT 10, min RTT 10
+            test.execute(WriteBytes{string(300, 'x')});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 101));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 201));
+
+            // more than a segment in flight: the probe comes after 2 SRTT
+            test.execute(Tick{19});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 201));
+            test.execute(ExpectNoSegment{});
+
+            // all three were lost; the RTO resends the first
+            test.execute(Tick{1000});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+            test.execute(ExpectNoSegment{});
+
+            // its ack shows the two after it, sent long before, are lost too
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 101}}.with_win(1000));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 101));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 201));
+            test.execute(ExpectNoSegment{});
+
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 301}}.with_win(1000));
+            test.execute(Tick{5000});
+            test.execute(ExpectNoSegment{});
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.mss = 100;
+            cfg.gso_segments = 4;
+            cfg.rack_tlp = true;
+
+            TCPSenderTestHarness test{"RACK resends only the first MSS of a lost super-segment", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_win(1000));  // SRTT 10, min RTT 10
+            test.execute(WriteBytes{string(100, 'x')});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+            test.execute(WriteBytes{string(400, 'y')});
+            test.execute(ExpectSegment{}.with_payload_size(400).with_seqno(isn + 101));
+
+            // the probe is the super-segment's last MSS
+            test.execute(Tick{20});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 401));
+
+            // all was lost; the RTO resends the first segment, and its ack shows the super-segment lost
+            test.execute(Tick{1000});
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 1));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 101}}.with_win(1000));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 101));
+            test.execute(ExpectNoSegment{});
+
+            // each partial ack of it resends the next MSS
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 201}}.with_win(1000));
+            test.execute(ExpectSegment{}.with_payload_size(100).with_seqno(isn + 201));
+            test.execute(ExpectNoSegment{});
+
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 501}}.with_win(1000));
+            test.execute(Tick{5000});
+            test.execute(ExpectNoSegment{});
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include "retransmission_queue.hh"
+#include "tcp_segment.hh"
+#include "test_err_if.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static TCPSegment segment_of(const size_t len) {
+    TCPSegment seg;
+    seg.payload() = string(len, 'x');
+    return seg;
+}
+
+int main() {
+    try {
+        RetransmissionQueue queue;
+        uint64_t next = 1;  // absolute seqno after the SYN
+        uint64_t acked = 1;
+
+        // keep the ring wrapping and growing: add three segments for every two acknowledged
+        for (size_t round = 0; round < 200; ++round) {
+            for (size_t i = 0; i < 3; ++i) {
+                const size_t len = 1 + (round * 3 + i) % 7;
+                queue.push(next, segment_of(len));
+                next += len;
+            }
+            const uint64_t ackno = queue[2].seqno;
+            test_err_if(queue.acknowledge(ackno) != 2, "wrong number of segments freed");
+            test_err_if(queue.front().seqno != ackno, "front isn't the first unacknowledged segment");
+            acked = ackno;
+        }
+        test_err_if(queue.size() != 200, "wrong size after pushes and acks");
+        test_err_if(queue.back().end != next, "back doesn't end at the next seqno");
+
+        // the entries survive the wrapping and growing in order, each where the last one ended
+        uint64_t expected = acked;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const auto &entry = queue[i];
+            test_err_if(entry.seqno != expected, "segments out of order");
+            test_err_if(entry.segment.payload().size() != entry.end - entry.seqno, "segment doesn't match its range");
+            expected = entry.end;
+        }
+
+        // an ackno inside a segment frees only the segments before it
+        const uint64_t inside = queue[5].seqno + 1;
+        test_err_if(queue.acknowledge(inside) != 5, "partial ack freed the wrong segments");
+
+        test_err_if(queue.acknowledge(next) != 195 || !queue.empty(), "full ack left segments behind");
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return err_num;
+    }
+
+    return EXIT_SUCCESS;
+}
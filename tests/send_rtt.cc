@@ -0,0 +1,154 @@
+#include "sender_harness.hh"
+#include "tcp_connection.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        auto rd = get_random_generator();
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.adaptive_rto = true;
+
+            TCPSenderTestHarness test{"RTO follows the measured RTT", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{40});
+            test.execute(AckReceived{WrappingInt32{isn + 1}});  // SRTT 40, RTTVAR 20, RTO 120
+
+            test.execute(WriteBytes{"abc"});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{20});
+            test.execute(AckReceived{WrappingInt32{isn + 4}});  // SRTT 37.5, RTTVAR 20, RTO 118
+
+            test.execute(WriteBytes{"def"});
+            test.execute(ExpectSegment{}.with_data("def"));
+            test.execute(Tick{117});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("def"));
+
+            // Karn's rule: the ack of a retransmitted segment gives no sample, so the RTO stays 118
+            test.execute(Tick{5});
+            test.execute(AckReceived{WrappingInt32{isn + 7}});
+            test.execute(WriteBytes{"ghi"});
+            test.execute(ExpectSegment{}.with_data("ghi"));
+            test.execute(Tick{117});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("ghi"));
+
+            // backoff doubles the timeout
+            test.execute(Tick{235});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("ghi"));
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.adaptive_rto = true;
+
+            TCPSenderTestHarness test{"Echoed timestamps give an RTT sample even for a retransmission", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{40});
+            test.execute(AckReceived{WrappingInt32{isn + 1}}.with_echo(40));  // SRTT 40, RTTVAR 20, RTO 120
+
+            test.execute(WriteBytes{"abc"});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{120});
+            test.execute(ExpectSegment{}.with_data("abc"));
+
+            // the echo tells the ack answers the retransmission: SRTT 36.25, RTTVAR 22.5, RTO 127
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{isn + 4}}.with_echo(10));
+            test.execute(WriteBytes{"def"});
+            test.execute(ExpectSegment{}.with_data("def"));
+            test.execute(Tick{126});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("def"));
+        }
+
+        {
+            TCPConfig cfg;
+            WrappingInt32 isn(rd());
+            cfg.fixed_isn = isn;
+            cfg.adaptive_rto = true;
+            cfg.rto_min = 200;
+            cfg.rto_max = 300;
+
+            TCPSenderTestHarness test{"RTO is kept within its bounds", cfg};
+            test.execute(ExpectSegment{}.with_no_flags().with_syn(true).with_payload_size(0).with_seqno(isn));
+            test.execute(Tick{1});
+            test.execute(AckReceived{WrappingInt32{isn + 1}});
+
+            test.execute(WriteBytes{"abc"});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{199});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{299});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("abc"));
+            test.execute(Tick{299});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_data("abc"));
+        }
+
+        {
+            RTTEstimator rtt{1000, 1, 60000};
+            if (rtt.has_sample() or rtt.rto() != 1000) {
+                throw runtime_error("RTO should start at its initial value");
+            }
+            for (int i = 0; i < 100; ++i) {
+                rtt.sample(50);
+            }
+            if (rtt.srtt() < 49.9 or rtt.srtt() > 50.1 or rtt.min_rtt() != 50 or rtt.rto() > 52) {
+                throw runtime_error("steady samples should converge SRTT on the RTT and RTTVAR on zero");
+            }
+        }
+
+        // the connection makes its sender's estimate available to its owner
+        {
+            TCPConfig cfg;
+            cfg.adaptive_rto = true;
+            TCPConnection conn{cfg};
+            conn.connect();
+            const TCPSegment syn = conn.segments_out().front();
+            conn.segments_out().pop();
+            conn.tick(30);
+
+            TCPSegment syn_ack;
+            syn_ack.header().syn = true;
+            syn_ack.header().ack = true;
+            syn_ack.header().seqno = WrappingInt32(rd());
+            syn_ack.header().ackno = syn.header().seqno + 1;
+            syn_ack.header().win = 1000;
+            conn.segment_received(syn_ack);
+            if (not conn.rtt().has_sample() or conn.rtt().latest_rtt() != 30 or conn.rtt().rto() != 90) {
+                throw runtime_error("connection doesn't report the handshake's RTT");
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
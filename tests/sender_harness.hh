@@ -99,6 +99,22 @@ struct ExpectBytesInFlight : public SenderExpectation {
     }
 };
 
+struct ExpectCongestionWindow : public SenderExpectation {
+    uint64_t _cwnd;
+
+    ExpectCongestionWindow(uint64_t cwnd) : _cwnd(cwnd) {}
+    std::string description() const { return "congestion window of " + std::to_string(_cwnd) + " bytes"; }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.cwnd() != _cwnd) {
+            std::ostringstream ss;
+            ss << "The TCPSender reported a congestion window of " << sender.cwnd()
+               << " bytes, but it was expected to be " << _cwnd << " bytes";
+            throw SenderExpectationViolation(ss.str());
+        }
+    }
+};
+
 struct ExpectNoSegment : public SenderExpectation {
     ExpectNoSegment() {}
     std::string description() const { return "no (more) segments"; }
@@ -191,11 +207,15 @@ struct Tick : public SenderAction {
 struct AckReceived : public SenderAction {
     WrappingInt32 _ackno;
     std::optional<uint16_t> _window_advertisement{};
+    std::optional<uint32_t> _echo_ms_ago{};
 
     AckReceived(WrappingInt32 ackno) : _ackno(ackno) {}
     std::string description() const {
         std::ostringstream ss;
         ss << "ack " << _ackno.raw_value() << " winsize " << _window_advertisement.value_or(DEFAULT_TEST_WINDOW);
+        if (_echo_ms_ago.has_value()) {
+            ss << " echoing a timestamp from " << _echo_ms_ago.value() << " ms ago";
+        }
         return ss.str();
     }
 
@@ -204,8 +224,16 @@ struct AckReceived : public SenderAction {
         return *this;
     }
 
+    //! the ack's TSecr echoes the TSval the sender stamped `ms_ago` milliseconds ago
+    AckReceived &with_echo(uint32_t ms_ago) {
+        _echo_ms_ago.emplace(ms_ago);
+        return *this;
+    }
+
     void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
-        sender.ack_received(_ackno, _window_advertisement.value_or(DEFAULT_TEST_WINDOW));
+        const auto tsecr =
+            _echo_ms_ago.has_value() ? std::optional<uint32_t>{sender.ts_val() - *_echo_ms_ago} : std::nullopt;
+        sender.ack_received(_ackno, _window_advertisement.value_or(DEFAULT_TEST_WINDOW), true, tsecr);
         sender.fill_window();
     }
 };
@@ -394,7 +422,7 @@ class TCPSenderTestHarness {
   public:
     TCPSenderTestHarness(const std::string &name_, TCPConfig config)
         : outbound_segments()
-        , sender(config.send_capacity, config.rt_timeout, config.fixed_isn)
+        , sender(config)
         , steps_executed()
         , name(name_) {
         sender.fill_window();
@@ -392,6 +392,9 @@ struct SendSegment : public TCPAction {
     uint16_t win{0};
     size_t payload_size{0};
     std::string data{};
+    std::optional<uint16_t> mss{};
+    std::optional<uint8_t> wscale{};
+    std::optional<TCPOptions::Timestamps> timestamps{};
 
     SendSegment() {}
 
@@ -404,6 +407,9 @@ struct SendSegment : public TCPAction {
         ackno = seg.header().ackno;
         win = seg.header().win;
         data = seg.payload();
+        mss = seg.header().options.mss;
+        wscale = seg.header().options.wscale;
+        timestamps = seg.header().options.timestamps;
     }
 
     SendSegment &with_ack(bool ack_) {
@@ -445,6 +451,21 @@ struct SendSegment : public TCPAction {
         return *this;
     }
 
+    SendSegment &with_mss(uint16_t mss_) {
+        mss = mss_;
+        return *this;
+    }
+
+    SendSegment &with_wscale(uint8_t wscale_) {
+        wscale = wscale_;
+        return *this;
+    }
+
+    SendSegment &with_timestamps(uint32_t val, uint32_t ecr) {
+        timestamps = TCPOptions::Timestamps{val, ecr};
+        return *this;
+    }
+
     SendSegment &with_payload_size(size_t payload_size_) {
         payload_size = payload_size_;
         return *this;
@@ -466,6 +487,9 @@ struct SendSegment : public TCPAction {
         data_hdr.ackno = ackno;
         data_hdr.seqno = seqno;
         data_hdr.win = win;
+        data_hdr.options.mss = mss;
+        data_hdr.options.wscale = wscale;
+        data_hdr.options.timestamps = timestamps;
         return data_seg;
     }
 
@@ -559,6 +583,16 @@ struct Listen : public TCPAction {
     void execute(TCPTestHarness &) const {}
 };
 
+struct Cork : public TCPAction {
+    std::string description() const { return "cork"; }
+    void execute(TCPTestHarness &harness) const { harness._fsm.cork(); }
+};
+
+struct Uncork : public TCPAction {
+    std::string description() const { return "uncork"; }
+    void execute(TCPTestHarness &harness) const { harness._fsm.uncork(); }
+};
+
 struct Close : public TCPAction {
     std::string description() const { return "close"; }
     void execute(TCPTestHarness &harness) const { harness._fsm.end_input_stream(); }
@@ -32,7 +32,7 @@ class TestFD : public FileDescriptor {
     TestRFD _recv_fd;  //!< The end of a SOCK_SEQPACKET socket pair from which TCPTestHarness reads
 
     //! Max-sized segment plus some margin
-    static constexpr size_t MAX_RECV = TCPConfig::MAX_PAYLOAD_SIZE + TCPHeader::LENGTH + 16;
+    static constexpr size_t MAX_RECV = TCPConfig::MAX_PAYLOAD_SIZE + TCPHeader::LENGTH + TCPOptions::MAX_LENGTH;
 
     //! Construct from a pair of sockets
     explicit TestFD(std::pair<FileDescriptor, TestRFD> fd_pair);
@@ -0,0 +1,176 @@
+#include "socket.hh"
+#include "tcp_config.hh"
+#include "tcp_segment.hh"
+#include "tcp_sponge_socket.hh"
+#include "util.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+//! Block until `event` becomes readable, then reset it
+static void wait_for(EventFD &event) {
+    pollfd pfd{event.fd_num(), POLLIN, 0};
+    SystemCall("poll", ::poll(&pfd, 1, 1000));
+    event.drain();
+}
+
+//! Write `data` through `outbound` in uneven pieces, as the TCP thread frees space, until all of it
+//! is written or the stream reports an error
+//! \returns the number of bytes written
+static size_t write_all(SPSCByteStream &outbound, const string &data) {
+    auto rd = get_random_generator();
+    size_t offset = 0;
+    while (offset < data.size() and not outbound.error()) {
+        const size_t len = min(data.size() - offset, size_t(1 + rd() % 1500));
+        const size_t written = outbound.write(string_view(data).substr(offset, len));
+        offset += written;
+        if (written == 0 and not outbound.error()) {
+            wait_for(outbound.space_event());
+        }
+    }
+    return offset;
+}
+
+int main() {
+    try {
+        const size_t LEN = 1024 * 1024;
+        auto rd = get_random_generator();
+        string data(LEN, 0);
+        for (auto &ch : data) {
+            ch = rd();
+        }
+
+        TCPConfig cfg;
+        cfg.rt_timeout = 100;
+
+        // both ends exchange a stream through the handoff streams, and both see it end cleanly
+        {
+            UDPSocket server_udp;
+            server_udp.bind(Address("127.0.0.1", 0));
+            UDPSocket client_udp;
+            client_udp.bind(Address("127.0.0.1", 0));
+
+            FdAdapterConfig server_ad;
+            server_ad.source = server_udp.local_address();
+            FdAdapterConfig client_ad;
+            client_ad.source = client_udp.local_address();
+            client_ad.destination = server_udp.local_address();
+
+            TCPOverUDPSpongeSocket server{TCPOverUDPSocketAdapter(move(server_udp))};
+            TCPOverUDPSpongeSocket client{TCPOverUDPSocketAdapter(move(client_udp))};
+            server.use_stream_handoff(4093);
+            client.use_stream_handoff(4093);
+
+            // the server reads everything through its inbound handoff stream, on its own thread
+            string received;
+            thread server_thread([&] {
+                server.listen_and_accept(cfg, server_ad);
+                SPSCByteStream &inbound = server.handoff_inbound();
+                while (not inbound.eof() and not inbound.error()) {
+                    if (inbound.buffer_empty()) {
+                        wait_for(inbound.data_event());
+                        continue;
+                    }
+                    received.append(inbound.read(1 + rd() % 2000));
+                }
+                server.handoff_outbound().end_input();
+                server.wait_until_closed();
+            });
+
+            client.connect(cfg, client_ad);
+            if (write_all(client.handoff_outbound(), data) != LEN) {
+                throw runtime_error("handoff write stopped early");
+            }
+            client.handoff_outbound().end_input();
+
+            SPSCByteStream &inbound = client.handoff_inbound();
+            while (not inbound.eof() and not inbound.error()) {
+                wait_for(inbound.data_event());
+            }
+            client.wait_until_closed();
+            server_thread.join();
+
+            if (inbound.error() or server.handoff_inbound().error()) {
+                throw runtime_error("clean close reported as an error");
+            }
+            if (received != data) {
+                throw runtime_error("bytes received do not match bytes sent (" + to_string(received.size()) + " of " +
+                                    to_string(LEN) + " received)");
+            }
+        }
+
+        // the peer resets while the owner is blocked on a full outbound handoff stream: the write
+        // returns, and the inbound stream reports an error rather than a clean end
+        {
+            UDPSocket peer;
+            peer.bind(Address("127.0.0.1", 0));
+            UDPSocket client_udp;
+            client_udp.bind(Address("127.0.0.1", 0));
+
+            FdAdapterConfig client_ad;
+            client_ad.source = client_udp.local_address();
+            client_ad.destination = peer.local_address();
+
+            TCPOverUDPSpongeSocket client{TCPOverUDPSocketAdapter(move(client_udp))};
+            client.use_stream_handoff(4093);
+
+            // the peer accepts the connection, takes one segment of data without acknowledging it,
+            // gives the owner time to fill the handoff stream, then resets
+            thread peer_thread([&] {
+                auto dgram = peer.recv();
+                TCPSegment syn;
+                if (syn.parse(move(dgram.payload), 0) != ParseResult::NoError or not syn.header().syn) {
+                    throw runtime_error("peer didn't get a SYN");
+                }
+
+                const WrappingInt32 isn(rd());
+                TCPSegment syn_ack;
+                syn_ack.header().syn = true;
+                syn_ack.header().ack = true;
+                syn_ack.header().seqno = isn;
+                syn_ack.header().ackno = syn.header().seqno + 1;
+                syn_ack.header().win = 1000;
+                peer.sendto(dgram.source_address, syn_ack.serialize(0));
+
+                TCPSegment seg;
+                do {
+                    dgram = peer.recv();
+                } while (seg.parse(move(dgram.payload), 0) != ParseResult::NoError or seg.payload().size() == 0);
+                this_thread::sleep_for(chrono::milliseconds(200));
+
+                TCPSegment rst;
+                rst.header().rst = true;
+                rst.header().seqno = isn + 1;
+                peer.sendto(dgram.source_address, rst.serialize(0));
+            });
+
+            client.connect(cfg, client_ad);
+            const auto start = chrono::steady_clock::now();
+            const size_t written = write_all(client.handoff_outbound(), data);
+            const auto elapsed = chrono::steady_clock::now() - start;
+            peer_thread.join();
+
+            if (written == LEN or elapsed > chrono::seconds(5)) {
+                throw runtime_error("handoff write didn't stop at the reset");
+            }
+            SPSCByteStream &inbound = client.handoff_inbound();
+            if (not inbound.error() or inbound.input_ended()) {
+                throw runtime_error("reset reported as a clean end of the inbound stream");
+            }
+            client.wait_until_closed();
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <pcap/pcap.h>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace std;
@@ -118,6 +119,49 @@ int main(int argc, char **argv) {
             }
         }
 
+        // options survive a round trip, and SACK blocks that don't fit are left out
+        {
+            TCPHeader test_2{};
+            test_2.syn = true;
+            test_2.options.mss = 1460;
+            test_2.options.wscale = 7;
+            test_2.options.sack_permitted = true;
+            test_2.options.timestamps = TCPOptions::Timestamps{0x01020304, 0};
+            for (uint32_t i = 0; i < TCPOptions::MAX_SACK_BLOCKS; ++i) {
+                test_2.options.add_sack_block(WrappingInt32{1000 * i}, WrappingInt32{1000 * i + 500});
+            }
+
+            const string serialized = test_2.serialize();
+            if (serialized.size() != TCPHeader::LENGTH + TCPOptions::MAX_LENGTH) {
+                throw runtime_error("bad serialize: wrong header length with options");
+            }
+
+            TCPHeader test_3{};
+            NetParser p{string(serialized)};
+            if (const auto res = test_3.parse(p); res != ParseResult::NoError) {
+                throw runtime_error("header with options parse failed: " + as_string(res));
+            }
+            if (test_3.doff != 15 || test_3.options.mss != 1460 || test_3.options.wscale != 7 ||
+                !test_3.options.sack_permitted || test_3.options.timestamps->val != 0x01020304 ||
+                test_3.options.sack_count != 2 || !(test_3.options.sack_blocks[1].right == WrappingInt32{1500})) {
+                throw runtime_error("bad parse: wrong options after round trip: " + test_3.options.to_string());
+            }
+
+            // unknown and malformed options are skipped
+            vector<uint8_t> test_header(40, 0);
+            test_header[12] = 0xa0;
+            const vector<uint8_t> opts{1, 30, 4, 0xaa, 0xbb, 8, 10, 0, 0, 0, 5, 0, 0, 0, 6, 3, 2};
+            copy(opts.begin(), opts.end(), test_header.begin() + TCPHeader::LENGTH);
+            NetParser p2{string(test_header.begin(), test_header.end())};
+            if (const auto res = test_3.parse(p2); res != ParseResult::NoError) {
+                throw runtime_error("header with unknown options parse failed: " + as_string(res));
+            }
+            if (test_3.options.mss || test_3.options.wscale || !test_3.options.timestamps ||
+                test_3.options.timestamps->val != 5 || test_3.options.timestamps->ecr != 6) {
+                throw runtime_error("bad parse: wrong options around unknown ones: " + test_3.options.to_string());
+            }
+        }
+
         // now process some segments off the wire for correctness of parser and unparser
         if (argc < 2) {
             cout << "USAGE: " << argv[0] << " <filename>" << endl;
@@ -191,12 +235,12 @@ int main(int argc, char **argv) {
             TCPSegment tcp_seg_copy;
             tcp_seg_copy.payload() = tcp_seg.payload();
 
-            // set headers in new segment, and fix up to remove extensions
+            // set headers in new segment, keeping the options but not the length
             {
                 auto &tcp_hdr_orig = tcp_seg.header();
                 TCPHeader &tcp_hdr_copy = tcp_seg_copy.header();
                 tcp_hdr_copy = tcp_hdr_orig;
-                // fix up segment to remove IPv4 and TCP header extensions
+                // serializing must work out the header length from the options
                 tcp_hdr_copy.doff = 5;
             }  // tcp_hdr_{orig,copy} go out of scope
 
@@ -220,8 +264,8 @@ int main(int argc, char **argv) {
                 ok = false;
                 continue;
             }
-            if (!compare_tcp_headers(tcp_seg_copy.header(), tcp_seg_copy2.header())) {
-                cout << "ERROR: after re-parsing, TCP headers don't match.\n";
+            if (!compare_tcp_headers(tcp_seg.header(), tcp_seg_copy2.header())) {
+                cout << "ERROR: after re-parsing, TCP header lengths or options don't match.\n";
                 ok = false;
                 continue;
             }
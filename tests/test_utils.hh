@@ -36,7 +36,7 @@ inline bool compare_tcp_headers_nolen(const TCPHeader &h1, const TCPHeader &h2)
 }
 
 inline bool compare_tcp_headers(const TCPHeader &h1, const TCPHeader &h2) {
-    return compare_tcp_headers_nolen(h1, h2) && h1.doff == h2.doff;
+    return compare_tcp_headers_nolen(h1, h2) && h1.doff == h2.doff && h1.options == h2.options;
 }
 
 #endif  // SPONGE_TESTS_TEST_UTILS_HH